@@ -0,0 +1,14 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+using UnrealBuildTool;
+
+public class GridCore : ModuleRules
+{
+	public GridCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		//The grid core only depends on Core so it can be used without any UObject/engine code
+		PublicDependencyModuleNames.AddRange(new string[] { "Core" });
+	}
+}
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridAStar.h"
+#include "GridStats.h"
+#include "Misc/ScopeExit.h"
+
+namespace
+{
+	//Lower f first, ties go to the tile closer to the goal
+	FORCEINLINE int64 MakeKey(int32 fCost_, int32 hCost_)
+	{
+		return ((int64)fCost_ << 32) | (int64)hCost_;
+	}
+}
+
+bool FGridAStar::FindPath(const FGridMap& grid_, FGridSearchContext& context_, int32 start_, int32 goal_, const FGridBitset* allowed_, TArray<int32>& outPath_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridAStar);
+	outPath_.Reset();
+	if (!grid_.IsValidIndex(start_) || !grid_.IsValidIndex(goal_))
+		return false;
+
+	context_.Begin(grid_.Num());
+	ON_SCOPE_EXIT { context_.ReportStats(); };
+	FGridIndexedHeap& open = context_.GetOpenList();
+
+	const int32 startH = grid_.GetDistanceEstimate(start_, goal_);
+	context_.Visit(start_, 0, INDEX_NONE);
+	open.Push(start_, MakeKey(startH, startH));
+
+	while (!open.IsEmpty())
+	{
+		const int32 current = open.Pop();
+		if (current == goal_)
+		{
+			context_.BuildPath(start_, goal_, outPath_);
+			return true;
+		}
+
+		context_.Close(current);
+		const int32 currentG = context_.GetGCost(current);
+
+		const int32 x = grid_.GetX(current);
+		const int32 y = grid_.GetY(current);
+		for (int32 d = 0; d < FGridMap::NumDirections; d++)
+		{
+			const int32 nx = x + FGridMap::DirectionX[d];
+			const int32 ny = y + FGridMap::DirectionY[d];
+			if (!grid_.IsValid(nx, ny))
+				continue;
+
+			const int32 neighbor = grid_.ToIndex(nx, ny);
+			if (context_.IsClosed(neighbor) || !grid_.IsTraversable(neighbor) || (allowed_ && !allowed_->Get(neighbor)))
+				continue;
+
+			const int32 gCost = currentG + grid_.GetStepCost(current, neighbor, FGridMap::IsDiagonal(d));
+			if (gCost < context_.GetGCost(neighbor))
+			{
+				const int32 hCost = grid_.GetDistanceEstimate(neighbor, goal_);
+				context_.Visit(neighbor, gCost, current);
+				open.Update(neighbor, MakeKey(gCost + hCost, hCost));
+			}
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridAnyAngle.h"
+
+namespace
+{
+	FORCEINLINE bool IsOpen(const FGridMap& grid_, int32 x_, int32 y_, const FGridBitset* allowed_, uint8 maxTerrainCost_)
+	{
+		if (!grid_.IsValid(x_, y_))
+			return false;
+		const int32 tile = grid_.ToIndex(x_, y_);
+		return grid_.IsTraversable(tile) && (!allowed_ || allowed_->Get(tile)) && grid_.GetTerrainCost(tile) <= maxTerrainCost_;
+	}
+}
+
+void FGridAnyAngle::ReducePath(const FGridMap& grid_, int32 start_, const TArray<int32>& path_, const FGridBitset* allowed_, TArray<int32>& outWaypoints_)
+{
+	outWaypoints_.Reset();
+	if (!grid_.IsValidIndex(start_))
+	{
+		outWaypoints_ = path_;
+		return;
+	}
+
+	//Greedy: from each waypoint, go as far along the path as a straight line can. The next tile is always
+	//reachable, even when the path cuts a corner that a straight line doesn't allow
+	int32 anchor = start_;
+	int32 i = 0;
+	while (i < path_.Num())
+	{
+		uint8 maxTerrainCost = FMath::Max(grid_.GetTerrainCost(anchor), grid_.GetTerrainCost(path_[i]));
+		int32 farthest = i;
+		while (farthest + 1 < path_.Num())
+		{
+			const uint8 nextTerrainCost = FMath::Max(maxTerrainCost, grid_.GetTerrainCost(path_[farthest + 1]));
+			if (!IsWalkable(grid_, anchor, path_[farthest + 1], allowed_, nextTerrainCost))
+				break;
+			maxTerrainCost = nextTerrainCost;
+			farthest++;
+		}
+		outWaypoints_.Add(path_[farthest]);
+		anchor = path_[farthest];
+		i = farthest + 1;
+	}
+}
+
+bool FGridAnyAngle::IsWalkable(const FGridMap& grid_, int32 from_, int32 to_, const FGridBitset* allowed_, uint8 maxTerrainCost_)
+{
+	//Supercover line: every tile the segment between the centers passes through, in order
+	int32 x = grid_.GetX(from_);
+	int32 y = grid_.GetY(from_);
+	const int32 toX = grid_.GetX(to_);
+	const int32 toY = grid_.GetY(to_);
+	const int32 dx = FMath::Abs(toX - x);
+	const int32 dy = FMath::Abs(toY - y);
+	const int32 stepX = x < toX ? 1 : -1;
+	const int32 stepY = y < toY ? 1 : -1;
+	int32 error = dx - dy;
+	for (int32 n = dx + dy; n > 0; n--)
+	{
+		if (error > 0)
+		{
+			x += stepX;
+			error -= 2 * dy;
+		}
+		else if (error < 0)
+		{
+			y += stepY;
+			error += 2 * dx;
+		}
+		else
+		{
+			//Exactly through a corner, both tiles beside it are touched
+			if (!IsOpen(grid_, x + stepX, y, allowed_, maxTerrainCost_) || !IsOpen(grid_, x, y + stepY, allowed_, maxTerrainCost_))
+				return false;
+			x += stepX;
+			y += stepY;
+			error += 2 * dx - 2 * dy;
+			n--;
+		}
+		if (!IsOpen(grid_, x, y, allowed_, maxTerrainCost_))
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridAsyncQuery.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+
+TUniquePtr<FGridSearchContext> FGridSearchContextPool::Acquire()
+{
+	FScopeLock scopeLock(&lock);
+	if (contexts.Num() > 0)
+	{
+		return contexts.Pop(false);
+	}
+	return MakeUnique<FGridSearchContext>();
+}
+
+void FGridSearchContextPool::Release(TUniquePtr<FGridSearchContext> context_)
+{
+	FScopeLock scopeLock(&lock);
+	contexts.Add(MoveTemp(context_));
+}
+
+FGridAsyncQuery::FGridAsyncQuery()
+	: bCancelled(false)
+{
+}
+
+void FGridAsyncQuery::Cancel()
+{
+	bCancelled = true;
+}
+
+TSharedRef<FGridAsyncQuery, ESPMode::ThreadSafe> FGridAsyncQuery::Launch(const FGridSearchContextPoolRef& pool_, TFunction<void(FGridSearchContext&)> work_, TFunction<void()> onComplete_)
+{
+	TSharedRef<FGridAsyncQuery, ESPMode::ThreadSafe> query = MakeShared<FGridAsyncQuery, ESPMode::ThreadSafe>();
+
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [query, pool_, work = MoveTemp(work_), onComplete = MoveTemp(onComplete_)]() mutable
+	{
+		//Don't bother searching for someone who stopped waiting
+		if (!query->IsCancelled())
+		{
+			TUniquePtr<FGridSearchContext> context = pool_->Acquire();
+			work(*context);
+			pool_->Release(MoveTemp(context));
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [query, onComplete = MoveTemp(onComplete)]()
+		{
+			if (!query->IsCancelled())
+			{
+				onComplete();
+			}
+		});
+	});
+
+	return query;
+}
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridBatchSearch.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/ThreadSafeCounter.h"
+
+void FGridBatchSearch::FindPaths(FGridSearchContextPool& pool_, const TArray<FGridPathRequest>& requests_, FGridPathSearchRef search_, TArray<FGridPathResult>& outResults_)
+{
+	outResults_.Reset();
+	outResults_.SetNum(requests_.Num());
+	if (requests_.Num() == 0)
+		return;
+
+	//One task per core, each one pulls requests until there are none left
+	const int32 numWorkers = FMath::Min(requests_.Num(), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	FThreadSafeCounter nextRequest;
+	ParallelFor(numWorkers, [&](int32)
+	{
+		TUniquePtr<FGridSearchContext> context = pool_.Acquire();
+		for (int32 i = nextRequest.Increment() - 1; i < requests_.Num(); i = nextRequest.Increment() - 1)
+		{
+			FGridPathResult& result = outResults_[i];
+			result.bFound = search_(*context, requests_[i].start, requests_[i].goal, result.path);
+		}
+		pool_.Release(MoveTemp(context));
+	});
+}
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridCore.h"
+#include "GridStats.h"
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, GridCore);
+
+DEFINE_LOG_CATEGORY(LogGridCore)
+
+DEFINE_STAT(STAT_GridAStar);
+DEFINE_STAT(STAT_GridJumpPoint);
+DEFINE_STAT(STAT_GridHierarchyPath);
+DEFINE_STAT(STAT_GridHierarchyBuild);
+DEFINE_STAT(STAT_GridHierarchyUpdate);
+DEFINE_STAT(STAT_GridDStarLite);
+DEFINE_STAT(STAT_GridRange);
+DEFINE_STAT(STAT_GridStepRange);
+DEFINE_STAT(STAT_GridFlowField);
+DEFINE_STAT(STAT_GridVisibility);
+DEFINE_STAT(STAT_GridNodesExpanded);
+DEFINE_STAT(STAT_GridOpenListPeak);
@@ -0,0 +1,226 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridDStarLite.h"
+#include "GridStats.h"
+
+FGridDStarLite::FGridDStarLite()
+	: start(INDEX_NONE)
+	, goal(INDEX_NONE)
+	, keyModifier(0)
+	, nodesExpanded(0)
+	, generation(0)
+	, heuristicTerrainCost(GridCost::DefaultTerrain)
+{
+}
+
+void FGridDStarLite::Init(const FGridMap& grid_, int32 start_, int32 goal_)
+{
+	start = INDEX_NONE;
+	goal = INDEX_NONE;
+	keyModifier = 0;
+	nodesExpanded = 0;
+	heuristicTerrainCost = grid_.GetMinTerrainCost();
+	if (!grid_.IsValidIndex(start_) || !grid_.IsValidIndex(goal_))
+		return;
+
+	if (stamps.Num() != grid_.Num() || generation == MAX_uint32)
+	{
+		stamps.Init(0, grid_.Num());
+		gCost.SetNumUninitialized(grid_.Num());
+		rhsCost.SetNumUninitialized(grid_.Num());
+		open.Init(grid_.Num());
+		generation = 0;
+	}
+	else
+	{
+		open.Reset();
+	}
+	generation++;
+
+	start = start_;
+	goal = goal_;
+	//A blocked goal still gets its cost, stepping onto it is what's not allowed
+	Touch(goal_);
+	rhsCost[goal_] = 0;
+	open.Push(goal_, CalculateKey(grid_, goal_));
+}
+
+void FGridDStarLite::Touch(int32 tile_)
+{
+	if (!IsTouched(tile_))
+	{
+		stamps[tile_] = generation;
+		gCost[tile_] = MAX_int32;
+		rhsCost[tile_] = MAX_int32;
+	}
+}
+
+int64 FGridDStarLite::CalculateKey(const FGridMap& grid_, int32 tile_) const
+{
+	//Lexicographic (min(g, rhs) + h + km, min(g, rhs)) packed into one heap key
+	const int32 cost = FMath::Min(GetG(tile_), GetRhs(tile_));
+	if (cost == MAX_int32)
+		return MAX_int64;
+	return ((int64)(cost + grid_.GetDistanceEstimate(start, tile_) + keyModifier) << 32) | (int64)cost;
+}
+
+void FGridDStarLite::SetStart(const FGridMap& grid_, int32 start_)
+{
+	if (!IsActive() || start_ == start || !grid_.IsValidIndex(start_))
+		return;
+
+	keyModifier += grid_.GetDistanceEstimate(start, start_);
+	start = start_;
+}
+
+void FGridDStarLite::UpdateTile(const FGridMap& grid_, int32 tile_)
+{
+	if (tile_ != goal)
+	{
+		//Corners can be cut, so a step only needs the tile it lands on to be traversable
+		int32 rhs = MAX_int32;
+		const int32 x = grid_.GetX(tile_);
+		const int32 y = grid_.GetY(tile_);
+		for (int32 d = 0; d < FGridMap::NumDirections; d++)
+		{
+			const int32 nx = x + FGridMap::DirectionX[d];
+			const int32 ny = y + FGridMap::DirectionY[d];
+			if (!grid_.IsValid(nx, ny))
+				continue;
+
+			const int32 neighbor = grid_.ToIndex(nx, ny);
+			const int32 g = GetG(neighbor);
+			if (g != MAX_int32 && grid_.IsTraversable(neighbor))
+			{
+				rhs = FMath::Min(rhs, g + grid_.GetStepCost(tile_, neighbor, FGridMap::IsDiagonal(d)));
+			}
+		}
+		if (rhs == MAX_int32 && !IsTouched(tile_))
+			return;
+		Touch(tile_);
+		rhsCost[tile_] = rhs;
+	}
+
+	if (GetG(tile_) != GetRhs(tile_))
+	{
+		open.Update(tile_, CalculateKey(grid_, tile_));
+	}
+	else if (open.Contains(tile_))
+	{
+		open.Remove(tile_);
+	}
+}
+
+void FGridDStarLite::UpdateNeighbors(const FGridMap& grid_, int32 tile_)
+{
+	const int32 x = grid_.GetX(tile_);
+	const int32 y = grid_.GetY(tile_);
+	for (int32 d = 0; d < FGridMap::NumDirections; d++)
+	{
+		const int32 nx = x + FGridMap::DirectionX[d];
+		const int32 ny = y + FGridMap::DirectionY[d];
+		if (grid_.IsValid(nx, ny))
+		{
+			UpdateTile(grid_, grid_.ToIndex(nx, ny));
+		}
+	}
+}
+
+void FGridDStarLite::NotifyTileChanged(const FGridMap& grid_, int32 tile_)
+{
+	if (!IsActive() || !grid_.IsValidIndex(tile_))
+		return;
+
+	//The heuristic is scaled by the cheapest terrain, keys computed with another scale can't be repaired
+	if (grid_.GetMinTerrainCost() != heuristicTerrainCost)
+	{
+		Init(grid_, start, goal);
+		return;
+	}
+
+	//Every step onto or off the tile changed cost, those are part of its own and its neighbors' rhs
+	UpdateTile(grid_, tile_);
+	UpdateNeighbors(grid_, tile_);
+}
+
+void FGridDStarLite::ComputeShortestPath(const FGridMap& grid_)
+{
+	while (!open.IsEmpty() && (open.TopKey() < CalculateKey(grid_, start) || GetRhs(start) != GetG(start)))
+	{
+		const int32 current = open.Top();
+		const int64 oldKey = open.TopKey();
+		const int64 newKey = CalculateKey(grid_, current);
+		nodesExpanded++;
+
+		if (oldKey < newKey)
+		{
+			//The start moved since it was queued
+			open.Update(current, newKey);
+		}
+		else if (GetG(current) > GetRhs(current))
+		{
+			gCost[current] = rhsCost[current];
+			open.Pop();
+			UpdateNeighbors(grid_, current);
+		}
+		else
+		{
+			gCost[current] = MAX_int32;
+			UpdateTile(grid_, current);
+			UpdateNeighbors(grid_, current);
+		}
+	}
+}
+
+bool FGridDStarLite::FindPath(const FGridMap& grid_, TArray<int32>& outPath_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridDStarLite);
+	outPath_.Reset();
+	nodesExpanded = 0;
+	if (!IsActive())
+		return false;
+	if (start == goal)
+		return true;
+
+	ComputeShortestPath(grid_);
+	INC_DWORD_STAT_BY(STAT_GridNodesExpanded, nodesExpanded);
+	if (GetG(start) == MAX_int32)
+		return false;
+
+	//Walk downhill on g from the start
+	int32 current = start;
+	while (current != goal && outPath_.Num() < grid_.Num())
+	{
+		const int32 x = grid_.GetX(current);
+		const int32 y = grid_.GetY(current);
+		int32 best = INDEX_NONE;
+		int32 bestCost = MAX_int32;
+		for (int32 d = 0; d < FGridMap::NumDirections; d++)
+		{
+			const int32 nx = x + FGridMap::DirectionX[d];
+			const int32 ny = y + FGridMap::DirectionY[d];
+			if (!grid_.IsValid(nx, ny))
+				continue;
+
+			const int32 neighbor = grid_.ToIndex(nx, ny);
+			const int32 g = GetG(neighbor);
+			if (g == MAX_int32 || !grid_.IsTraversable(neighbor))
+				continue;
+
+			const int32 cost = g + grid_.GetStepCost(current, neighbor, FGridMap::IsDiagonal(d));
+			if (cost < bestCost)
+			{
+				best = neighbor;
+				bestCost = cost;
+			}
+		}
+		if (best == INDEX_NONE)
+		{
+			outPath_.Reset();
+			return false;
+		}
+		outPath_.Add(best);
+		current = best;
+	}
+	return current == goal;
+}
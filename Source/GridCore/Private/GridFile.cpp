@@ -0,0 +1,238 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridFile.h"
+#include "GridHierarchy.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/BufferReader.h"
+#include "Serialization/MemoryWriter.h"
+
+const uint32 FGridFile::Magic = 0x44495247; //"GRID"
+const uint32 FGridFile::FormatVersion = 1;
+
+namespace
+{
+	struct FGridFileHeader
+	{
+		uint32 magic;
+		uint32 version;
+		int32 width;
+		int32 height;
+		int32 numSections;
+		uint32 reserved;
+	};
+
+	struct FGridFileSectionEntry
+	{
+		uint32 id;
+		uint32 reserved;
+		int64 offset;
+		int64 size;
+	};
+
+	static_assert(sizeof(FGridFileHeader) == 24 && sizeof(FGridFileSectionEntry) == 24, "Grid file layout changed");
+
+	const int64 SectionAlignment = 8;
+
+	FORCEINLINE const FGridFileSectionEntry* GetSectionTable(const uint8* data_)
+	{
+		return reinterpret_cast<const FGridFileSectionEntry*>(data_ + sizeof(FGridFileHeader));
+	}
+}
+
+FGridFile::FGridFile()
+	: data(nullptr)
+	, size(0)
+	, width(0)
+	, height(0)
+{
+}
+
+FGridFile::~FGridFile()
+{
+	Close();
+}
+
+bool FGridFile::Save(const TCHAR* filename_, const FGridMap& grid_, const FGridHierarchy* hierarchy_)
+{
+	struct FSection
+	{
+		EGridFileSection id;
+		const void* data;
+		int64 size;
+	};
+	TArray<FSection> sections;
+
+	const TArray<uint64>& words = grid_.GetTraversableMask().GetWords();
+	sections.Add({ EGridFileSection::Traversable, words.GetData(), (int64)words.Num() * (int64)sizeof(uint64) });
+	if (!grid_.HasUniformTerrain() || grid_.GetMinTerrainCost() != GridCost::DefaultTerrain)
+	{
+		const TArray<uint8>& terrain = grid_.GetTerrainCosts();
+		sections.Add({ EGridFileSection::Terrain, terrain.GetData(), (int64)terrain.Num() });
+	}
+
+	TArray<uint8> hierarchyData;
+	if (hierarchy_ && hierarchy_->IsBuilt())
+	{
+		//Serialize only reads from the hierarchy when saving
+		FMemoryWriter writer(hierarchyData);
+		const_cast<FGridHierarchy*>(hierarchy_)->Serialize(writer);
+		sections.Add({ EGridFileSection::Hierarchy, hierarchyData.GetData(), (int64)hierarchyData.Num() });
+	}
+
+	FGridFileHeader header;
+	header.magic = Magic;
+	header.version = FormatVersion;
+	header.width = grid_.GetWidth();
+	header.height = grid_.GetHeight();
+	header.numSections = sections.Num();
+	header.reserved = 0;
+
+	TArray<FGridFileSectionEntry> table;
+	int64 offset = sizeof(FGridFileHeader) + sections.Num() * sizeof(FGridFileSectionEntry);
+	for (const FSection& section : sections)
+	{
+		offset = Align(offset, SectionAlignment);
+		table.Add({ (uint32)section.id, 0, offset, section.size });
+		offset += section.size;
+	}
+
+	TArray<uint8> file;
+	file.SetNumZeroed(offset);
+	FMemory::Memcpy(file.GetData(), &header, sizeof(header));
+	FMemory::Memcpy(file.GetData() + sizeof(header), table.GetData(), table.Num() * sizeof(FGridFileSectionEntry));
+	for (int32 i = 0; i < sections.Num(); i++)
+	{
+		FMemory::Memcpy(file.GetData() + table[i].offset, sections[i].data, sections[i].size);
+	}
+	return FFileHelper::SaveArrayToFile(file, filename_);
+}
+
+bool FGridFile::Open(const TCHAR* filename_)
+{
+	Close();
+
+	mappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(filename_));
+	if (mappedFile.IsValid())
+	{
+		mappedRegion.Reset(mappedFile->MapRegion());
+		if (mappedRegion.IsValid())
+		{
+			data = mappedRegion->GetMappedPtr();
+			size = mappedRegion->GetMappedSize();
+		}
+	}
+
+	if (!data)
+	{
+		mappedRegion.Reset();
+		mappedFile.Reset();
+		if (FFileHelper::LoadFileToArray(fileData, filename_, FILEREAD_Silent))
+		{
+			data = fileData.GetData();
+			size = fileData.Num();
+		}
+	}
+
+	if (!data || !ReadHeader())
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void FGridFile::Close()
+{
+	//The region has to go before the file it maps
+	mappedRegion.Reset();
+	mappedFile.Reset();
+	fileData.Empty();
+	data = nullptr;
+	size = 0;
+	width = 0;
+	height = 0;
+}
+
+bool FGridFile::ReadHeader()
+{
+	if (size < (int64)sizeof(FGridFileHeader))
+		return false;
+
+	FGridFileHeader header;
+	FMemory::Memcpy(&header, data, sizeof(header));
+	if (header.magic != Magic || header.version != FormatVersion || header.width < 0 || header.height < 0 || header.numSections < 0)
+		return false;
+	if ((int64)header.width * header.height > MAX_int32)
+		return false;
+
+	const int64 tableEnd = sizeof(FGridFileHeader) + (int64)header.numSections * sizeof(FGridFileSectionEntry);
+	if (tableEnd > size)
+		return false;
+
+	//Sections are only range checked here. LoadGrid checks their sizes and the hierarchy checks its own data
+	const FGridFileSectionEntry* table = GetSectionTable(data);
+	for (int32 i = 0; i < header.numSections; i++)
+	{
+		if (table[i].offset < tableEnd || table[i].size < 0 || table[i].offset > size - table[i].size)
+			return false;
+	}
+
+	width = header.width;
+	height = header.height;
+	return true;
+}
+
+const uint8* FGridFile::FindSection(EGridFileSection section_, int64& outSize_) const
+{
+	outSize_ = 0;
+	if (!data)
+		return nullptr;
+
+	FGridFileHeader header;
+	FMemory::Memcpy(&header, data, sizeof(header));
+	const FGridFileSectionEntry* table = GetSectionTable(data);
+	for (int32 i = 0; i < header.numSections; i++)
+	{
+		if (table[i].id == (uint32)section_)
+		{
+			outSize_ = table[i].size;
+			return data + table[i].offset;
+		}
+	}
+	return nullptr;
+}
+
+bool FGridFile::LoadGrid(FGridMap& outGrid_) const
+{
+	int64 sectionSize;
+	const uint8* section = FindSection(EGridFileSection::Traversable, sectionSize);
+	const int64 numWords = FMath::DivideAndRoundUp(width * height, 64);
+	if (!section || sectionSize < numWords * (int64)sizeof(uint64))
+		return false;
+
+	const uint8* terrain = FindSection(EGridFileSection::Terrain, sectionSize);
+	if (terrain && sectionSize < (int64)width * height)
+		return false;
+
+	outGrid_.Init(width, height, reinterpret_cast<const uint64*>(section));
+	if (terrain)
+	{
+		outGrid_.SetTerrainCosts(terrain);
+	}
+	return true;
+}
+
+bool FGridFile::LoadHierarchy(const FGridMap& grid_, int32 clusterSize_, FGridHierarchy& outHierarchy_) const
+{
+	int64 sectionSize;
+	const uint8* section = FindSection(EGridFileSection::Hierarchy, sectionSize);
+	if (!section || grid_.GetWidth() != width || grid_.GetHeight() != height)
+		return false;
+
+	//Reads straight from the mapped memory, the reader doesn't own or modify it
+	FBufferReader reader(const_cast<uint8*>(section), sectionSize, false);
+	outHierarchy_.Serialize(reader);
+	return !reader.IsError() && outHierarchy_.IsBuiltFor(grid_, clusterSize_);
+}
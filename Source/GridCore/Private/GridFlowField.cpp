@@ -0,0 +1,142 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridFlowField.h"
+#include "GridStats.h"
+#include "Misc/ScopeExit.h"
+
+const uint8 FGridFlowField::NoDirection;
+
+FGridFlowField::FGridFlowField()
+	: goal(INDEX_NONE)
+	, width(0)
+	, version(0)
+{
+}
+
+void FGridFlowField::Build(const FGridMap& grid_, FGridSearchContext& context_, int32 goal_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridFlowField);
+	goal = goal_;
+	width = grid_.GetWidth();
+	version = grid_.GetVersion();
+	costs.Init(MAX_int32, grid_.Num());
+	directions.Init(NoDirection, grid_.Num());
+	if (!grid_.IsValidIndex(goal_) || !grid_.IsTraversable(goal_))
+		return;
+
+	context_.Begin(grid_.Num());
+	ON_SCOPE_EXIT { context_.ReportStats(); };
+	FGridIndexedHeap& open = context_.GetOpenList();
+	context_.Visit(goal_, 0, INDEX_NONE);
+	open.Push(goal_, 0);
+
+	while (!open.IsEmpty())
+	{
+		const int32 current = open.Pop();
+		const int32 currentG = context_.GetGCost(current);
+		context_.Close(current);
+		costs[current] = currentG;
+
+		const int32 x = grid_.GetX(current);
+		const int32 y = grid_.GetY(current);
+		for (int32 d = 0; d < FGridMap::NumDirections; d++)
+		{
+			const int32 nx = x + FGridMap::DirectionX[d];
+			const int32 ny = y + FGridMap::DirectionY[d];
+			if (!grid_.IsValid(nx, ny))
+				continue;
+
+			const int32 neighbor = grid_.ToIndex(nx, ny);
+			if (context_.IsClosed(neighbor) || !grid_.IsTraversable(neighbor))
+				continue;
+
+			const int32 gCost = currentG + grid_.GetStepCost(current, neighbor, FGridMap::IsDiagonal(d));
+			if (gCost < context_.GetGCost(neighbor))
+			{
+				context_.Visit(neighbor, gCost, current);
+				open.Update(neighbor, gCost);
+				//The neighbor steps back the way we came. Opposite directions are 2 apart within each group of 4
+				directions[neighbor] = (uint8)((d & ~3) | ((d + 2) & 3));
+			}
+		}
+	}
+}
+
+int32 FGridFlowField::GetNextTile(int32 tile_) const
+{
+	const uint8 direction = directions[tile_];
+	if (direction == NoDirection)
+		return INDEX_NONE;
+	return tile_ + FGridMap::DirectionY[direction] * width + FGridMap::DirectionX[direction];
+}
+
+bool FGridFlowField::GetPath(int32 start_, TArray<int32>& outPath_) const
+{
+	outPath_.Reset();
+	if (!costs.IsValidIndex(start_) || !IsReachable(start_))
+		return false;
+
+	for (int32 tile = GetNextTile(start_); tile != INDEX_NONE; tile = GetNextTile(tile))
+	{
+		outPath_.Add(tile);
+	}
+	return true;
+}
+
+FGridFlowFieldCache::FGridFlowFieldCache()
+	: capacity(4)
+{
+}
+
+void FGridFlowFieldCache::SetCapacity(int32 capacity_)
+{
+	capacity = FMath::Max(capacity_, 1);
+	if (entries.Num() > capacity)
+	{
+		entries.RemoveAt(0, entries.Num() - capacity);
+	}
+}
+
+void FGridFlowFieldCache::Empty()
+{
+	entries.Empty();
+}
+
+const FGridFlowField& FGridFlowFieldCache::Find(const FGridMap& grid_, FGridSearchContext& context_, int32 goal_)
+{
+	const uint32 version = grid_.GetVersion();
+	int32 found = INDEX_NONE;
+	int32 stale = INDEX_NONE;
+	for (int32 i = 0; i < entries.Num(); i++)
+	{
+		if (entries[i]->GetVersion() != version)
+		{
+			stale = i;
+		}
+		else if (entries[i]->GetGoal() == goal_)
+		{
+			found = i;
+			break;
+		}
+	}
+
+	//Reuse an outdated or the least recently used field so its arrays don't get reallocated
+	const int32 taken = found != INDEX_NONE ? found : stale != INDEX_NONE ? stale : entries.Num() >= capacity ? 0 : INDEX_NONE;
+	TUniquePtr<FGridFlowField> entry;
+	if (taken != INDEX_NONE)
+	{
+		entry = MoveTemp(entries[taken]);
+		entries.RemoveAt(taken, 1, false);
+	}
+	else
+	{
+		entry = MakeUnique<FGridFlowField>();
+	}
+	if (found == INDEX_NONE)
+	{
+		entry->Build(grid_, context_, goal_);
+	}
+
+	entries.Add(MoveTemp(entry));
+	return *entries.Last();
+}
@@ -0,0 +1,611 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridHierarchy.h"
+#include "GridStats.h"
+#include "Misc/ScopeExit.h"
+#include "Algo/Reverse.h"
+
+namespace
+{
+	//Entrances at least this long get a node at each end instead of one in the middle
+	const int32 LongEntrance = 6;
+
+	FORCEINLINE int64 MakeKey(int32 fCost_, int32 hCost_)
+	{
+		return ((int64)fCost_ << 32) | (int64)hCost_;
+	}
+}
+
+FGridHierarchy::FGridHierarchy()
+	: clusterSize(0)
+	, clustersX(0)
+	, clustersY(0)
+{
+}
+
+void FGridHierarchy::Build(const FGridMap& grid_, int32 clusterSize_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridHierarchyBuild);
+	check(clusterSize_ > 0);
+	clusterSize = clusterSize_;
+	clustersX = FMath::DivideAndRoundUp(grid_.GetWidth(), clusterSize);
+	clustersY = FMath::DivideAndRoundUp(grid_.GetHeight(), clusterSize);
+
+	nodes.Reset();
+	freeNodes.Reset();
+	dirtyClusters.Reset();
+	clusters.Reset();
+	clusters.SetNum(clustersX * clustersY);
+	for (int32 c = 0; c < clusters.Num(); c++)
+	{
+		const int32 minX = (c % clustersX) * clusterSize;
+		const int32 minY = (c / clustersX) * clusterSize;
+		clusters[c].rect = FGridRect(minX, minY, FMath::Min(minX + clusterSize, grid_.GetWidth()) - 1, FMath::Min(minY + clusterSize, grid_.GetHeight()) - 1);
+	}
+
+	for (int32 c = 0; c < clusters.Num(); c++)
+	{
+		BuildBorder(grid_, c, false, nullptr);
+		BuildBorder(grid_, c, true, nullptr);
+	}
+	for (int32 c = 0; c < clusters.Num(); c++)
+	{
+		BuildDistances(grid_, c);
+	}
+}
+
+bool FGridHierarchy::IsBuiltFor(const FGridMap& grid_, int32 clusterSize_) const
+{
+	return IsBuilt() && clusterSize == clusterSize_
+		&& clustersX == FMath::DivideAndRoundUp(grid_.GetWidth(), clusterSize)
+		&& clustersY == FMath::DivideAndRoundUp(grid_.GetHeight(), clusterSize)
+		&& clusters.Last().rect.maxX == grid_.GetWidth() - 1 && clusters.Last().rect.maxY == grid_.GetHeight() - 1;
+}
+
+void FGridHierarchy::Serialize(FArchive& ar_)
+{
+	check(ar_.IsLoading() || dirtyClusters.Num() == 0);
+	ar_ << clusterSize << clustersX << clustersY;
+
+	int32 numNodes = nodes.Num();
+	int32 numClusters = clusters.Num();
+	ar_ << numNodes << numClusters;
+	if (ar_.IsLoading())
+	{
+		//Counts are checked against the archive size so a corrupt file can't ask for huge allocations
+		if (ar_.IsError() || clusterSize <= 0 || numNodes < 0 || numNodes > ar_.TotalSize()
+			|| clustersX < 0 || clustersY < 0 || numClusters > ar_.TotalSize() || numClusters != (int64)clustersX * clustersY)
+		{
+			ar_.SetError();
+			numNodes = 0;
+			numClusters = 0;
+		}
+		nodes.SetNumUninitialized(numNodes);
+		clusters.Reset();
+		clusters.SetNum(numClusters);
+		dirtyClusters.Reset();
+	}
+
+	for (FNode& node : nodes)
+	{
+		ar_ << node.tile << node.cluster << node.partner << node.partnerCost << node.slot;
+	}
+	ar_ << freeNodes;
+	for (FCluster& cluster : clusters)
+	{
+		ar_ << cluster.rect.minX << cluster.rect.minY << cluster.rect.maxX << cluster.rect.maxY;
+		ar_ << cluster.nodes << cluster.distances << cluster.eastBorder << cluster.northBorder;
+	}
+
+	//FindPath and Update index with the loaded ids without checking them
+	if (ar_.IsLoading() && !ar_.IsError() && !IsConsistent())
+	{
+		ar_.SetError();
+	}
+	if (ar_.IsLoading() && ar_.IsError())
+	{
+		nodes.Reset();
+		freeNodes.Reset();
+		clusters.Reset();
+		clustersX = 0;
+		clustersY = 0;
+	}
+}
+
+bool FGridHierarchy::IsConsistent() const
+{
+	if (clusters.Num() == 0)
+		return false;
+
+	//Clusters have to tile the map in order. The last one gives the grid size the tiles are checked against
+	for (int32 c = 0; c < clusters.Num(); c++)
+	{
+		const FGridRect& rect = clusters[c].rect;
+		const int32 cx = c % clustersX;
+		const int32 cy = c / clustersX;
+		const int64 rectWidth = (int64)rect.maxX - rect.minX + 1;
+		const int64 rectHeight = (int64)rect.maxY - rect.minY + 1;
+		if (rect.minX != (int64)cx * clusterSize || rect.minY != (int64)cy * clusterSize
+			|| rectWidth < 1 || rectHeight < 1 || rectWidth > clusterSize || rectHeight > clusterSize
+			|| (cx + 1 < clustersX && rectWidth != clusterSize) || (cy + 1 < clustersY && rectHeight != clusterSize)
+			|| (cx + 1 == clustersX && rect.maxX != clusters.Last().rect.maxX)
+			|| (cy + 1 == clustersY && rect.maxY != clusters.Last().rect.maxY))
+			return false;
+	}
+	const int64 width = (int64)clusters.Last().rect.maxX + 1;
+	if (width * ((int64)clusters.Last().rect.maxY + 1) > MAX_int32)
+		return false;
+
+	//Costs are bounded by the dearest step so sums of them can't overflow while searching
+	const int32 maxStep = GridCost::Diagonal * MAX_uint8 / GridCost::DefaultTerrain;
+	const int64 maxDistance = (int64)clusterSize * clusterSize * maxStep;
+
+	//Every node is either free or in exactly one slot of its cluster and one border
+	const uint8 Free = 1;
+	const uint8 InCluster = 2;
+	const uint8 InBorder = 3;
+	TArray<uint8> seen;
+	seen.Init(0, nodes.Num());
+	for (int32 id : freeNodes)
+	{
+		if (!nodes.IsValidIndex(id) || nodes[id].cluster != INDEX_NONE || seen[id])
+			return false;
+		seen[id] = Free;
+	}
+	for (int32 c = 0; c < clusters.Num(); c++)
+	{
+		const FCluster& cluster = clusters[c];
+		const int32 num = cluster.nodes.Num();
+		if ((int64)num * num != cluster.distances.Num())
+			return false;
+		for (int32 i = 0; i < num; i++)
+		{
+			const int32 id = cluster.nodes[i];
+			if (!nodes.IsValidIndex(id) || nodes[id].cluster != c || nodes[id].slot != i || seen[id])
+				return false;
+			seen[id] = InCluster;
+		}
+		for (int32 distance : cluster.distances)
+		{
+			if (distance < 0 || (distance > maxDistance && distance != MAX_int32))
+				return false;
+		}
+	}
+	auto MarkBorder = [&](const TArray<int32>& border_)
+	{
+		for (int32 id : border_)
+		{
+			if (!nodes.IsValidIndex(id) || seen[id] != InCluster)
+				return false;
+			seen[id] = InBorder;
+		}
+		return true;
+	};
+	for (const FCluster& cluster : clusters)
+	{
+		if (!MarkBorder(cluster.eastBorder) || !MarkBorder(cluster.northBorder))
+			return false;
+	}
+
+	for (int32 id = 0; id < nodes.Num(); id++)
+	{
+		const FNode& node = nodes[id];
+		if (node.cluster == INDEX_NONE)
+		{
+			if (seen[id] != Free)
+				return false;
+			continue;
+		}
+		if (seen[id] != InBorder || node.tile < 0)
+			return false;
+
+		//Entrances are a single step between tiles of two clusters
+		const int32 x = (int32)(node.tile % width);
+		const int32 y = (int32)(node.tile / width);
+		if (!clusters[node.cluster].rect.Contains(x, y) || !nodes.IsValidIndex(node.partner))
+			return false;
+		const FNode& partner = nodes[node.partner];
+		if (partner.cluster == INDEX_NONE || partner.cluster == node.cluster || partner.partner != id
+			|| partner.partnerCost != node.partnerCost || node.partnerCost < 0 || node.partnerCost > maxStep
+			|| FMath::Abs(partner.tile % width - x) > 1 || FMath::Abs(partner.tile / width - y) > 1)
+			return false;
+	}
+	return true;
+}
+
+int32 FGridHierarchy::GetCluster(const FGridMap& grid_, int32 tile_) const
+{
+	return (grid_.GetX(tile_) / clusterSize) + (grid_.GetY(tile_) / clusterSize) * clustersX;
+}
+
+void FGridHierarchy::MarkTileChanged(const FGridMap& grid_, int32 tile_)
+{
+	if (IsBuilt())
+	{
+		dirtyClusters.AddUnique(GetCluster(grid_, tile_));
+	}
+}
+
+void FGridHierarchy::Update(const FGridMap& grid_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridHierarchyUpdate);
+	if (dirtyClusters.Num() == 0)
+		return;
+
+	//Rebuild every border that has tiles in a dirty cluster: its own east and north borders, the east borders
+	//of its west, south-west and north-west neighbors and the north border of its south neighbor
+	TArray<int32> changedClusters;
+	for (int32 i = 0; i < dirtyClusters.Num(); i++)
+	{
+		const int32 c = dirtyClusters[i];
+		const int32 cx = c % clustersX;
+		const int32 cy = c / clustersX;
+		changedClusters.AddUnique(c);
+
+		BuildBorder(grid_, c, false, &changedClusters);
+		BuildBorder(grid_, c, true, &changedClusters);
+		if (cx > 0)
+		{
+			BuildBorder(grid_, c - 1, false, &changedClusters);
+			if (cy > 0)
+				BuildBorder(grid_, c - 1 - clustersX, false, &changedClusters);
+			if (cy + 1 < clustersY)
+				BuildBorder(grid_, c - 1 + clustersX, false, &changedClusters);
+		}
+		if (cy > 0)
+		{
+			BuildBorder(grid_, c - clustersX, true, &changedClusters);
+		}
+	}
+
+	for (int32 i = 0; i < changedClusters.Num(); i++)
+	{
+		BuildDistances(grid_, changedClusters[i]);
+	}
+	dirtyClusters.Reset();
+}
+
+int32 FGridHierarchy::AddNode(int32 tile_, int32 cluster_, TArray<int32>* changed_)
+{
+	FNode node;
+	node.tile = tile_;
+	node.cluster = cluster_;
+	node.partner = INDEX_NONE;
+	node.partnerCost = MAX_int32;
+	node.slot = clusters[cluster_].nodes.Num();
+
+	int32 id;
+	if (freeNodes.Num() > 0)
+	{
+		id = freeNodes.Pop(false);
+		nodes[id] = node;
+	}
+	else
+	{
+		id = nodes.Add(node);
+	}
+	clusters[cluster_].nodes.Add(id);
+	if (changed_)
+		changed_->AddUnique(cluster_);
+	return id;
+}
+
+void FGridHierarchy::RemoveNode(int32 node_, TArray<int32>* changed_)
+{
+	const int32 cluster = nodes[node_].cluster;
+	TArray<int32>& clusterNodes = clusters[cluster].nodes;
+	clusterNodes.Remove(node_);
+	for (int32 i = 0; i < clusterNodes.Num(); i++)
+	{
+		nodes[clusterNodes[i]].slot = i;
+	}
+	nodes[node_].cluster = INDEX_NONE;
+	freeNodes.Add(node_);
+	if (changed_)
+		changed_->AddUnique(cluster);
+}
+
+void FGridHierarchy::BuildBorder(const FGridMap& grid_, int32 cluster_, bool bNorth_, TArray<int32>* changed_)
+{
+	FCluster& cluster = clusters[cluster_];
+	TArray<int32>& border = bNorth_ ? cluster.northBorder : cluster.eastBorder;
+	for (int32 i = 0; i < border.Num(); i++)
+	{
+		RemoveNode(border[i], changed_);
+	}
+	border.Reset();
+
+	const int32 cx = cluster_ % clustersX;
+	const int32 cy = cluster_ / clustersX;
+	if ((bNorth_ && cy + 1 >= clustersY) || (!bNorth_ && cx + 1 >= clustersX))
+		return;
+
+	const int32 length = bNorth_ ? cluster.rect.GetWidth() : cluster.rect.GetHeight();
+
+	//Tile on this side of the border at position i_ along it, and the tile across from it shifted by offset_
+	auto GetInside = [&](int32 i_)
+	{
+		return bNorth_ ? grid_.ToIndex(cluster.rect.minX + i_, cluster.rect.maxY) : grid_.ToIndex(cluster.rect.maxX, cluster.rect.minY + i_);
+	};
+	auto GetOutside = [&](int32 i_, int32 offset_)
+	{
+		const int32 x = bNorth_ ? cluster.rect.minX + i_ + offset_ : cluster.rect.maxX + 1;
+		const int32 y = bNorth_ ? cluster.rect.maxY + 1 : cluster.rect.minY + i_ + offset_;
+		//Diagonals off the north edge that leave the cluster's columns belong to an east border
+		if (!grid_.IsValid(x, y) || (bNorth_ && (x < cluster.rect.minX || x > cluster.rect.maxX)))
+			return (int32)INDEX_NONE;
+		return grid_.ToIndex(x, y);
+	};
+	auto AddTransition = [&](int32 inside_, int32 outside_, bool bDiagonal_)
+	{
+		const int32 cost = grid_.GetStepCost(inside_, outside_, bDiagonal_);
+		const int32 a = AddNode(inside_, cluster_, changed_);
+		const int32 b = AddNode(outside_, GetCluster(grid_, outside_), changed_);
+		nodes[a].partner = b;
+		nodes[a].partnerCost = cost;
+		nodes[b].partner = a;
+		nodes[b].partnerCost = cost;
+		border.Add(a);
+		border.Add(b);
+	};
+
+	//Every run of tiles that are open straight across the border is one entrance
+	int32 runStart = INDEX_NONE;
+	for (int32 i = 0; i <= length; i++)
+	{
+		bool bOpen = false;
+		if (i < length)
+		{
+			const int32 inside = GetInside(i);
+			const int32 outside = GetOutside(i, 0);
+			bOpen = grid_.IsTraversable(inside) && grid_.IsTraversable(outside);
+
+			//Where the straight step is blocked a diagonal one might still cross. It only needs its own transition
+			//when the tile next to us along the border can't take the straight step instead
+			if (grid_.IsTraversable(inside) && !grid_.IsTraversable(outside))
+			{
+				for (int32 offset = -1; offset <= 1; offset += 2)
+				{
+					const int32 diagonal = GetOutside(i, offset);
+					if (diagonal == INDEX_NONE || !grid_.IsTraversable(diagonal))
+						continue;
+					if (i + offset >= 0 && i + offset < length && grid_.IsTraversable(GetInside(i + offset)))
+						continue;
+					AddTransition(inside, diagonal, true);
+				}
+			}
+		}
+
+		if (bOpen && runStart == INDEX_NONE)
+		{
+			runStart = i;
+		}
+		else if (!bOpen && runStart != INDEX_NONE)
+		{
+			const int32 runEnd = i - 1;
+			if (runEnd - runStart + 1 >= LongEntrance)
+			{
+				AddTransition(GetInside(runStart), GetOutside(runStart, 0), false);
+				AddTransition(GetInside(runEnd), GetOutside(runEnd, 0), false);
+			}
+			else
+			{
+				const int32 middle = (runStart + runEnd) / 2;
+				AddTransition(GetInside(middle), GetOutside(middle, 0), false);
+			}
+			runStart = INDEX_NONE;
+		}
+	}
+}
+
+void FGridHierarchy::BuildDistances(const FGridMap& grid_, int32 cluster_)
+{
+	FCluster& cluster = clusters[cluster_];
+	const int32 num = cluster.nodes.Num();
+	cluster.distances.Init(MAX_int32, num * num);
+	for (int32 i = 0; i < num; i++)
+	{
+		cluster.distances[i * num + i] = 0;
+		if (i == num - 1)
+			break;
+
+		SearchInRect(grid_, buildContext, nodes[cluster.nodes[i]].tile, INDEX_NONE, cluster.rect);
+		for (int32 j = i + 1; j < num; j++)
+		{
+			const int32 cost = buildContext.GetGCost(nodes[cluster.nodes[j]].tile);
+			cluster.distances[i * num + j] = cost;
+			cluster.distances[j * num + i] = cost;
+		}
+	}
+}
+
+bool FGridHierarchy::SearchInRect(const FGridMap& grid_, FGridSearchContext& context_, int32 source_, int32 target_, const FGridRect& rect_)
+{
+	context_.Begin(grid_.Num());
+	ON_SCOPE_EXIT { context_.ReportStats(); };
+	FGridIndexedHeap& open = context_.GetOpenList();
+	context_.Visit(source_, 0, INDEX_NONE);
+	open.Push(source_, 0);
+
+	while (!open.IsEmpty())
+	{
+		const int32 current = open.Pop();
+		if (current == target_)
+			return true;
+
+		context_.Close(current);
+		const int32 currentG = context_.GetGCost(current);
+		const int32 x = grid_.GetX(current);
+		const int32 y = grid_.GetY(current);
+		for (int32 d = 0; d < FGridMap::NumDirections; d++)
+		{
+			const int32 nx = x + FGridMap::DirectionX[d];
+			const int32 ny = y + FGridMap::DirectionY[d];
+			if (!rect_.Contains(nx, ny))
+				continue;
+
+			const int32 neighbor = grid_.ToIndex(nx, ny);
+			if (context_.IsClosed(neighbor) || !grid_.IsTraversable(neighbor))
+				continue;
+
+			const int32 gCost = currentG + grid_.GetStepCost(current, neighbor, FGridMap::IsDiagonal(d));
+			if (gCost < context_.GetGCost(neighbor))
+			{
+				const int32 hCost = target_ != INDEX_NONE ? grid_.GetDistanceEstimate(neighbor, target_) : 0;
+				context_.Visit(neighbor, gCost, current);
+				open.Update(neighbor, MakeKey(gCost + hCost, hCost));
+			}
+		}
+	}
+	return target_ == INDEX_NONE;
+}
+
+bool FGridHierarchy::FindPath(const FGridMap& grid_, FGridSearchContext& context_, int32 start_, int32 goal_, TArray<int32>& outPath_, int32* outNodesExpanded_) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridHierarchyPath);
+	outPath_.Reset();
+	int32 nodesExpanded = 0;
+	ON_SCOPE_EXIT
+	{
+		if (outNodesExpanded_)
+			*outNodesExpanded_ = nodesExpanded;
+	};
+	if (!IsBuilt() || !grid_.IsValidIndex(start_) || !grid_.IsValidIndex(goal_))
+		return false;
+	if (start_ == goal_)
+		return true;
+	if (!grid_.IsTraversable(goal_))
+		return false;
+	checkSlow(!IsDirty());
+
+	const int32 startCluster = GetCluster(grid_, start_);
+	const int32 goalCluster = GetCluster(grid_, goal_);
+	const FCluster& startNodes = clusters[startCluster];
+	const FCluster& goalNodes = clusters[goalCluster];
+
+	//Connect the start and goal to the nodes of their clusters. They get the two ids after the real nodes
+	const int32 startId = nodes.Num();
+	const int32 goalId = nodes.Num() + 1;
+	TArray<int32> startCosts;
+	TArray<int32> goalCosts;
+	int32 directCost = MAX_int32;
+
+	SearchInRect(grid_, context_, start_, INDEX_NONE, startNodes.rect);
+	nodesExpanded += context_.GetNodesExpanded();
+	startCosts.SetNumUninitialized(startNodes.nodes.Num());
+	for (int32 i = 0; i < startNodes.nodes.Num(); i++)
+	{
+		startCosts[i] = context_.GetGCost(nodes[startNodes.nodes[i]].tile);
+	}
+	if (startCluster == goalCluster)
+	{
+		directCost = context_.GetGCost(goal_);
+	}
+
+	SearchInRect(grid_, context_, goal_, INDEX_NONE, goalNodes.rect);
+	nodesExpanded += context_.GetNodesExpanded();
+	goalCosts.SetNumUninitialized(goalNodes.nodes.Num());
+	for (int32 i = 0; i < goalNodes.nodes.Num(); i++)
+	{
+		goalCosts[i] = context_.GetGCost(nodes[goalNodes.nodes[i]].tile);
+	}
+
+	//A* on the abstract graph
+	TArray<int32> gCost;
+	TArray<int32> parent;
+	gCost.Init(MAX_int32, nodes.Num() + 2);
+	parent.Init(INDEX_NONE, nodes.Num() + 2);
+	FGridIndexedHeap open;
+	open.Init(nodes.Num() + 2);
+
+	auto GetTile = [&](int32 id_)
+	{
+		return id_ == startId ? start_ : (id_ == goalId ? goal_ : nodes[id_].tile);
+	};
+	auto Relax = [&](int32 from_, int32 to_, int32 cost_)
+	{
+		if (cost_ == MAX_int32)
+			return;
+		const int32 g = gCost[from_] + cost_;
+		if (g < gCost[to_])
+		{
+			const int32 h = grid_.GetDistanceEstimate(GetTile(to_), goal_);
+			gCost[to_] = g;
+			parent[to_] = from_;
+			open.Update(to_, MakeKey(g + h, h));
+		}
+	};
+
+	gCost[startId] = 0;
+	open.Push(startId, 0);
+	bool bFound = false;
+	while (!open.IsEmpty())
+	{
+		const int32 current = open.Pop();
+		nodesExpanded++;
+		if (current == goalId)
+		{
+			bFound = true;
+			break;
+		}
+
+		if (current == startId)
+		{
+			for (int32 i = 0; i < startNodes.nodes.Num(); i++)
+			{
+				Relax(current, startNodes.nodes[i], startCosts[i]);
+			}
+			Relax(current, goalId, directCost);
+			continue;
+		}
+
+		const FNode& node = nodes[current];
+		const FCluster& cluster = clusters[node.cluster];
+		const int32 num = cluster.nodes.Num();
+		Relax(current, node.partner, node.partnerCost);
+		for (int32 j = 0; j < num; j++)
+		{
+			if (j != node.slot)
+				Relax(current, cluster.nodes[j], cluster.distances[node.slot * num + j]);
+		}
+		if (node.cluster == goalCluster)
+		{
+			Relax(current, goalId, goalCosts[node.slot]);
+		}
+	}
+
+	if (!bFound)
+		return false;
+
+	TArray<int32> abstractPath;
+	for (int32 id = goalId; id != INDEX_NONE; id = parent[id])
+	{
+		abstractPath.Add(id);
+	}
+	Algo::Reverse(abstractPath);
+
+	//Refine each abstract edge. Entrance crossings are a single step, everything else stays inside one cluster
+	TArray<int32> segment;
+	for (int32 i = 0; i + 1 < abstractPath.Num(); i++)
+	{
+		const int32 from = abstractPath[i];
+		const int32 to = abstractPath[i + 1];
+		const int32 fromTile = GetTile(from);
+		const int32 toTile = GetTile(to);
+		if (fromTile == toTile)
+			continue;
+
+		if (from != startId && to != goalId && nodes[from].partner == to)
+		{
+			outPath_.Add(toTile);
+			continue;
+		}
+
+		const int32 cluster = from == startId ? startCluster : nodes[from].cluster;
+		SearchInRect(grid_, context_, fromTile, toTile, clusters[cluster].rect);
+		nodesExpanded += context_.GetNodesExpanded();
+		context_.BuildPath(fromTile, toTile, segment);
+		outPath_.Append(segment);
+	}
+	return true;
+}
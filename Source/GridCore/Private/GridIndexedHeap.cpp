@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridIndexedHeap.h"
+
+FGridIndexedHeap::FGridIndexedHeap()
+	: peak(0)
+{
+}
+
+void FGridIndexedHeap::Init(int32 numItems_)
+{
+	heap.Reset();
+	peak = 0;
+	positions.Init(INDEX_NONE, numItems_);
+}
+
+void FGridIndexedHeap::Reset()
+{
+	for (int32 i = 0; i < heap.Num(); i++)
+	{
+		positions[heap[i].item] = INDEX_NONE;
+	}
+	heap.Reset();
+	peak = 0;
+}
+
+void FGridIndexedHeap::Push(int32 item_, int64 key_)
+{
+	check(!Contains(item_));
+	FNode node;
+	node.key = key_;
+	node.item = item_;
+	heap.Add(node);
+	positions[item_] = heap.Num() - 1;
+	peak = FMath::Max(peak, heap.Num());
+	SiftUp(heap.Num() - 1);
+}
+
+void FGridIndexedHeap::Update(int32 item_, int64 key_)
+{
+	const int32 slot = positions[item_];
+	if (slot == INDEX_NONE)
+	{
+		Push(item_, key_);
+		return;
+	}
+
+	const int64 oldKey = heap[slot].key;
+	heap[slot].key = key_;
+	if (key_ < oldKey)
+		SiftUp(slot);
+	else if (key_ > oldKey)
+		SiftDown(slot);
+}
+
+int32 FGridIndexedHeap::Pop()
+{
+	check(heap.Num() > 0);
+	const int32 item = heap[0].item;
+	Remove(item);
+	return item;
+}
+
+void FGridIndexedHeap::Remove(int32 item_)
+{
+	const int32 slot = positions[item_];
+	check(slot != INDEX_NONE);
+	positions[item_] = INDEX_NONE;
+
+	//Move the last node into the hole and let it find its place
+	const FNode last = heap.Pop(false);
+	if (slot < heap.Num())
+	{
+		const int64 removedKey = heap[slot].key;
+		Place(slot, last);
+		if (last.key < removedKey)
+			SiftUp(slot);
+		else
+			SiftDown(slot);
+	}
+}
+
+void FGridIndexedHeap::SiftUp(int32 slot_)
+{
+	const FNode node = heap[slot_];
+	while (slot_ > 0)
+	{
+		const int32 parent = (slot_ - 1) >> 1;
+		if (heap[parent].key <= node.key)
+			break;
+		Place(slot_, heap[parent]);
+		slot_ = parent;
+	}
+	Place(slot_, node);
+}
+
+void FGridIndexedHeap::SiftDown(int32 slot_)
+{
+	const FNode node = heap[slot_];
+	const int32 num = heap.Num();
+	while (true)
+	{
+		int32 child = (slot_ << 1) + 1;
+		if (child >= num)
+			break;
+		if (child + 1 < num && heap[child + 1].key < heap[child].key)
+			child++;
+		if (node.key <= heap[child].key)
+			break;
+		Place(slot_, heap[child]);
+		slot_ = child;
+	}
+	Place(slot_, node);
+}
@@ -0,0 +1,234 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridJumpPointSearch.h"
+#include "GridStats.h"
+#include "Misc/ScopeExit.h"
+#include "GridAStar.h"
+
+namespace
+{
+	FORCEINLINE int64 MakeKey(int32 fCost_, int32 hCost_)
+	{
+		return ((int64)fCost_ << 32) | (int64)hCost_;
+	}
+
+	FORCEINLINE int32 Sign(int32 value_)
+	{
+		return (value_ > 0) - (value_ < 0);
+	}
+
+	struct FJumpQuery
+	{
+		const FGridMap& grid;
+		const FGridBitset* allowed;
+		int32 goalX;
+		int32 goalY;
+
+		FJumpQuery(const FGridMap& grid_, const FGridBitset* allowed_, int32 goal_)
+			: grid(grid_)
+			, allowed(allowed_)
+			, goalX(grid_.GetX(goal_))
+			, goalY(grid_.GetY(goal_))
+		{
+		}
+
+		FORCEINLINE bool IsOpen(int32 x_, int32 y_) const
+		{
+			if (!grid.IsValid(x_, y_))
+				return false;
+			const int32 index = grid.ToIndex(x_, y_);
+			return grid.IsTraversable(index) && (!allowed || allowed->Get(index));
+		}
+
+		FORCEINLINE bool IsGoal(int32 x_, int32 y_) const
+		{
+			return x_ == goalX && y_ == goalY;
+		}
+
+		//A blocked tile next to the line of travel that makes a tile behind it only reachable optimally through (x_, y_)
+		bool HasForcedNeighbor(int32 x_, int32 y_, int32 dx_, int32 dy_) const
+		{
+			if (dx_ != 0 && dy_ != 0)
+			{
+				return (!IsOpen(x_ - dx_, y_) && IsOpen(x_ - dx_, y_ + dy_))
+					|| (!IsOpen(x_, y_ - dy_) && IsOpen(x_ + dx_, y_ - dy_));
+			}
+			if (dx_ != 0)
+			{
+				return (!IsOpen(x_, y_ + 1) && IsOpen(x_ + dx_, y_ + 1))
+					|| (!IsOpen(x_, y_ - 1) && IsOpen(x_ + dx_, y_ - 1));
+			}
+			return (!IsOpen(x_ + 1, y_) && IsOpen(x_ + 1, y_ + dy_))
+				|| (!IsOpen(x_ - 1, y_) && IsOpen(x_ - 1, y_ + dy_));
+		}
+
+		//Moves from (x_, y_) in the given direction until it finds a jump point. Returns false if it runs into a wall
+		bool Jump(int32 x_, int32 y_, int32 dx_, int32 dy_, int32& outX_, int32& outY_) const
+		{
+			while (true)
+			{
+				x_ += dx_;
+				y_ += dy_;
+				if (!IsOpen(x_, y_))
+					return false;
+
+				if (IsGoal(x_, y_) || HasForcedNeighbor(x_, y_, dx_, dy_))
+				{
+					outX_ = x_;
+					outY_ = y_;
+					return true;
+				}
+
+				//A diagonal tile is a jump point if either of its straight components reaches one
+				if (dx_ != 0 && dy_ != 0)
+				{
+					int32 ignoredX, ignoredY;
+					if (Jump(x_, y_, dx_, 0, ignoredX, ignoredY) || Jump(x_, y_, 0, dy_, ignoredX, ignoredY))
+					{
+						outX_ = x_;
+						outY_ = y_;
+						return true;
+					}
+				}
+			}
+		}
+
+		//Directions worth jumping in from (x_, y_) when it was reached moving (dx_, dy_). (0, 0) means it's the start
+		int32 GetSuccessorDirections(int32 x_, int32 y_, int32 dx_, int32 dy_, int32* outDX_, int32* outDY_) const
+		{
+			int32 count = 0;
+			auto AddDirection = [&](int32 ddx_, int32 ddy_)
+			{
+				if (IsOpen(x_ + ddx_, y_ + ddy_))
+				{
+					outDX_[count] = ddx_;
+					outDY_[count] = ddy_;
+					count++;
+				}
+			};
+
+			if (dx_ == 0 && dy_ == 0)
+			{
+				for (int32 d = 0; d < FGridMap::NumDirections; d++)
+				{
+					AddDirection(FGridMap::DirectionX[d], FGridMap::DirectionY[d]);
+				}
+			}
+			else if (dx_ != 0 && dy_ != 0)
+			{
+				AddDirection(dx_, 0);
+				AddDirection(0, dy_);
+				AddDirection(dx_, dy_);
+				if (!IsOpen(x_ - dx_, y_))
+					AddDirection(-dx_, dy_);
+				if (!IsOpen(x_, y_ - dy_))
+					AddDirection(dx_, -dy_);
+			}
+			else if (dx_ != 0)
+			{
+				AddDirection(dx_, 0);
+				if (!IsOpen(x_, y_ + 1))
+					AddDirection(dx_, 1);
+				if (!IsOpen(x_, y_ - 1))
+					AddDirection(dx_, -1);
+			}
+			else
+			{
+				AddDirection(0, dy_);
+				if (!IsOpen(x_ + 1, y_))
+					AddDirection(1, dy_);
+				if (!IsOpen(x_ - 1, y_))
+					AddDirection(-1, dy_);
+			}
+			return count;
+		}
+	};
+}
+
+bool FGridJumpPointSearch::FindPath(const FGridMap& grid_, FGridSearchContext& context_, int32 start_, int32 goal_, const FGridBitset* allowed_, TArray<int32>& outPath_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridJumpPoint);
+	outPath_.Reset();
+	if (!grid_.IsValidIndex(start_) || !grid_.IsValidIndex(goal_))
+		return false;
+
+	if (start_ == goal_)
+		return true;
+
+	//Jumps skip over tiles without looking at their cost
+	if (!grid_.HasUniformTerrain())
+		return FGridAStar::FindPath(grid_, context_, start_, goal_, allowed_, outPath_);
+
+	const FJumpQuery query(grid_, allowed_, goal_);
+	if (!query.IsOpen(grid_.GetX(goal_), grid_.GetY(goal_)))
+		return false;
+
+	context_.Begin(grid_.Num());
+	ON_SCOPE_EXIT { context_.ReportStats(); };
+	FGridIndexedHeap& open = context_.GetOpenList();
+
+	const int32 startH = grid_.GetDistanceEstimate(start_, goal_);
+	context_.Visit(start_, 0, INDEX_NONE);
+	open.Push(start_, MakeKey(startH, startH));
+
+	int32 directionsX[FGridMap::NumDirections];
+	int32 directionsY[FGridMap::NumDirections];
+	while (!open.IsEmpty())
+	{
+		const int32 current = open.Pop();
+		if (current == goal_)
+		{
+			//Fill in the tiles between consecutive jump points, they're always on a straight or diagonal line
+			TArray<int32> jumpPoints;
+			context_.BuildPath(start_, goal_, jumpPoints);
+			int32 x = grid_.GetX(start_);
+			int32 y = grid_.GetY(start_);
+			for (int32 i = 0; i < jumpPoints.Num(); i++)
+			{
+				const int32 jumpX = grid_.GetX(jumpPoints[i]);
+				const int32 jumpY = grid_.GetY(jumpPoints[i]);
+				const int32 dx = Sign(jumpX - x);
+				const int32 dy = Sign(jumpY - y);
+				while (x != jumpX || y != jumpY)
+				{
+					x += dx;
+					y += dy;
+					outPath_.Add(grid_.ToIndex(x, y));
+				}
+			}
+			return true;
+		}
+
+		context_.Close(current);
+		const int32 currentG = context_.GetGCost(current);
+		const int32 x = grid_.GetX(current);
+		const int32 y = grid_.GetY(current);
+
+		//The direction we arrived from decides which neighbors can be pruned
+		const int32 parent = context_.GetParent(current);
+		const int32 dx = parent == INDEX_NONE ? 0 : Sign(x - grid_.GetX(parent));
+		const int32 dy = parent == INDEX_NONE ? 0 : Sign(y - grid_.GetY(parent));
+
+		const int32 numDirections = query.GetSuccessorDirections(x, y, dx, dy, directionsX, directionsY);
+		for (int32 d = 0; d < numDirections; d++)
+		{
+			int32 jumpX, jumpY;
+			if (!query.Jump(x, y, directionsX[d], directionsY[d], jumpX, jumpY))
+				continue;
+
+			const int32 jumpPoint = grid_.ToIndex(jumpX, jumpY);
+			if (context_.IsClosed(jumpPoint))
+				continue;
+
+			const int32 gCost = currentG + grid_.GetDistanceEstimate(current, jumpPoint);
+			if (gCost < context_.GetGCost(jumpPoint))
+			{
+				const int32 hCost = grid_.GetDistanceEstimate(jumpPoint, goal_);
+				context_.Visit(jumpPoint, gCost, current);
+				open.Update(jumpPoint, MakeKey(gCost + hCost, hCost));
+			}
+		}
+	}
+
+	return false;
+}
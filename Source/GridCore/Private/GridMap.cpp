@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridMap.h"
+
+//Right, up, left, down, then the 4 diagonals
+const int32 FGridMap::DirectionX[FGridMap::NumDirections] = { 1, 0, -1, 0, 1, -1, -1, 1 };
+const int32 FGridMap::DirectionY[FGridMap::NumDirections] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+
+FGridMap::FGridMap()
+	: width(0)
+	, height(0)
+	, version(0)
+{
+	ResetTerrain();
+}
+
+void FGridMap::Init(int32 width_, int32 height_)
+{
+	check(width_ >= 0 && height_ >= 0);
+	width = width_;
+	height = height_;
+
+	traversable.Init(Num(), true);
+	ResetTerrain();
+	version++;
+}
+
+void FGridMap::Init(int32 width_, int32 height_, const uint64* traversableWords_)
+{
+	check(width_ >= 0 && height_ >= 0);
+	width = width_;
+	height = height_;
+
+	traversable.Init(Num(), traversableWords_);
+	ResetTerrain();
+	version++;
+}
+
+int32 FGridMap::GetNeighbor(int32 index_, int32 direction_) const
+{
+	const int32 x = GetX(index_) + DirectionX[direction_];
+	const int32 y = GetY(index_) + DirectionY[direction_];
+	return IsValid(x, y) ? ToIndex(x, y) : INDEX_NONE;
+}
+
+void FGridMap::SetTraversable(int32 index_, bool value_)
+{
+	if (traversable.Get(index_) != value_)
+	{
+		traversable.Set(index_, value_);
+		version++;
+	}
+}
+
+void FGridMap::SetTerrainCost(int32 index_, uint8 cost_)
+{
+	cost_ = FMath::Max<uint8>(cost_, 1);
+	const uint8 previous = terrainCosts[index_];
+	if (previous != cost_)
+	{
+		terrainCosts[index_] = cost_;
+		terrainCounts[previous]--;
+		terrainCounts[cost_]++;
+		if (cost_ < minTerrainCost || (previous == minTerrainCost && terrainCounts[previous] == 0))
+		{
+			UpdateMinTerrainCost();
+		}
+		version++;
+	}
+}
+
+void FGridMap::SetTerrainCosts(const uint8* costs_)
+{
+	FMemory::Memzero(terrainCounts, sizeof(terrainCounts));
+	for (int32 i = 0; i < terrainCosts.Num(); i++)
+	{
+		terrainCosts[i] = FMath::Max<uint8>(costs_[i], 1);
+		terrainCounts[terrainCosts[i]]++;
+	}
+	UpdateMinTerrainCost();
+	version++;
+}
+
+void FGridMap::ResetTerrain()
+{
+	terrainCosts.Init(GridCost::DefaultTerrain, Num());
+	FMemory::Memzero(terrainCounts, sizeof(terrainCounts));
+	terrainCounts[GridCost::DefaultTerrain] = Num();
+	minTerrainCost = GridCost::DefaultTerrain;
+}
+
+void FGridMap::UpdateMinTerrainCost()
+{
+	minTerrainCost = GridCost::DefaultTerrain;
+	for (int32 cost = 1; cost < 256; cost++)
+	{
+		if (terrainCounts[cost] > 0)
+		{
+			minTerrainCost = (uint8)cost;
+			break;
+		}
+	}
+}
+
+int32 FGridMap::GetDistanceEstimate(int32 from_, int32 to_) const
+{
+	//Same rounding as GetStepCost, so a step over the cheapest terrain is never cheaper than its estimate
+	const int32 straight = GridCost::Straight * minTerrainCost / GridCost::DefaultTerrain;
+	const int32 diagonal = GridCost::Diagonal * minTerrainCost / GridCost::DefaultTerrain;
+	const int32 dx = FMath::Abs(GetX(from_) - GetX(to_));
+	const int32 dy = FMath::Abs(GetY(from_) - GetY(to_));
+	return straight * (dx + dy) + (diagonal - 2 * straight) * FMath::Min(dx, dy);
+}
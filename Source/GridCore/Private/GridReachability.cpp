@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridReachability.h"
+#include "GridStats.h"
+#include "Misc/ScopeExit.h"
+#include "Algo/Reverse.h"
+
+FGridReachability::FGridReachability()
+	: origin(INDEX_NONE)
+	, budget(0)
+	, version(0)
+{
+}
+
+void FGridReachability::Reset()
+{
+	origin = INDEX_NONE;
+	budget = 0;
+	version = 0;
+	tiles.Reset();
+	costs.Reset();
+	parents.Reset();
+	slots.Reset();
+}
+
+void FGridReachability::Compute(const FGridMap& grid_, FGridSearchContext& context_, int32 origin_, int32 budget_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridRange);
+	Reset();
+	if (!grid_.IsValidIndex(origin_))
+		return;
+
+	origin = origin_;
+	budget = budget_;
+	version = grid_.GetVersion();
+
+	context_.Begin(grid_.Num());
+	ON_SCOPE_EXIT { context_.ReportStats(); };
+	FGridIndexedHeap& open = context_.GetOpenList();
+	context_.Visit(origin_, 0, INDEX_NONE);
+	open.Push(origin_, 0);
+
+	while (!open.IsEmpty())
+	{
+		const int32 current = open.Pop();
+		const int32 currentG = context_.GetGCost(current);
+		context_.Close(current);
+
+		//Tiles come out of the heap cheapest first, so the parent always has a slot already
+		const int32 parent = context_.GetParent(current);
+		slots.Add(current, tiles.Num());
+		tiles.Add(current);
+		costs.Add(currentG);
+		parents.Add(parent == INDEX_NONE ? INDEX_NONE : slots.FindChecked(parent));
+
+		const int32 x = grid_.GetX(current);
+		const int32 y = grid_.GetY(current);
+		for (int32 d = 0; d < FGridMap::NumDirections; d++)
+		{
+			const int32 nx = x + FGridMap::DirectionX[d];
+			const int32 ny = y + FGridMap::DirectionY[d];
+			if (!grid_.IsValid(nx, ny))
+				continue;
+
+			const int32 neighbor = grid_.ToIndex(nx, ny);
+			if (context_.IsClosed(neighbor) || !grid_.IsTraversable(neighbor))
+				continue;
+
+			const int32 gCost = currentG + grid_.GetStepCost(current, neighbor, FGridMap::IsDiagonal(d));
+			if (gCost <= budget_ && gCost < context_.GetGCost(neighbor))
+			{
+				context_.Visit(neighbor, gCost, current);
+				open.Update(neighbor, gCost);
+			}
+		}
+	}
+}
+
+int32 FGridReachability::GetCost(int32 tile_) const
+{
+	const int32* slot = slots.Find(tile_);
+	return slot ? costs[*slot] : MAX_int32;
+}
+
+bool FGridReachability::GetPath(int32 goal_, TArray<int32>& outPath_) const
+{
+	outPath_.Reset();
+	const int32* slot = slots.Find(goal_);
+	if (!slot)
+		return false;
+
+	for (int32 s = *slot; parents[s] != INDEX_NONE; s = parents[s])
+	{
+		outPath_.Add(tiles[s]);
+	}
+	Algo::Reverse(outPath_);
+	return true;
+}
+
+FGridReachabilityCache::FGridReachabilityCache()
+	: capacity(8)
+	, hits(0)
+	, misses(0)
+{
+}
+
+void FGridReachabilityCache::SetCapacity(int32 capacity_)
+{
+	capacity = FMath::Max(capacity_, 1);
+	if (entries.Num() > capacity)
+	{
+		entries.RemoveAt(0, entries.Num() - capacity);
+	}
+}
+
+void FGridReachabilityCache::Empty()
+{
+	entries.Empty();
+}
+
+const FGridReachability* FGridReachabilityCache::FindCached(uint32 version_, int32 origin_, int32 budget_)
+{
+	const int32 found = FindEntry(version_, origin_, budget_);
+	if (found == INDEX_NONE)
+		return nullptr;
+
+	//Move it to the back so it's the last one to get dropped
+	TUniquePtr<FGridReachability> entry = MoveTemp(entries[found]);
+	entries.RemoveAt(found, 1, false);
+	entries.Add(MoveTemp(entry));
+	hits++;
+	return entries.Last().Get();
+}
+
+const FGridReachability& FGridReachabilityCache::Find(const FGridMap& grid_, FGridSearchContext& context_, int32 origin_, int32 budget_)
+{
+	if (const FGridReachability* cached = FindCached(grid_.GetVersion(), origin_, budget_))
+		return *cached;
+
+	misses++;
+	TUniquePtr<FGridReachability> entry = TakeEntry(grid_.GetVersion());
+	entry->Compute(grid_, context_, origin_, budget_);
+	entries.Add(MoveTemp(entry));
+	return *entries.Last();
+}
+
+const FGridReachability& FGridReachabilityCache::Add(FGridReachability&& range_)
+{
+	//Two queries for the same range can finish one after the other, keep only the newest
+	const int32 duplicate = FindEntry(range_.GetVersion(), range_.GetOrigin(), range_.GetBudget());
+	if (duplicate != INDEX_NONE)
+	{
+		entries.RemoveAt(duplicate, 1, false);
+	}
+
+	TUniquePtr<FGridReachability> entry = TakeEntry(range_.GetVersion());
+	*entry = MoveTemp(range_);
+	entries.Add(MoveTemp(entry));
+	return *entries.Last();
+}
+
+int32 FGridReachabilityCache::FindEntry(uint32 version_, int32 origin_, int32 budget_) const
+{
+	for (int32 i = 0; i < entries.Num(); i++)
+	{
+		const FGridReachability& entry = *entries[i];
+		if (entry.GetVersion() == version_ && entry.GetOrigin() == origin_ && entry.GetBudget() == budget_)
+			return i;
+	}
+	return INDEX_NONE;
+}
+
+TUniquePtr<FGridReachability> FGridReachabilityCache::TakeEntry(uint32 version_)
+{
+	//Prefer an entry from an older grid version since it can never be hit again, then the least recently used one
+	int32 recycled = INDEX_NONE;
+	for (int32 i = 0; i < entries.Num() && recycled == INDEX_NONE; i++)
+	{
+		if (entries[i]->GetVersion() != version_)
+		{
+			recycled = i;
+		}
+	}
+	if (recycled == INDEX_NONE && entries.Num() >= capacity)
+	{
+		recycled = 0;
+	}
+	if (recycled == INDEX_NONE)
+	{
+		return MakeUnique<FGridReachability>();
+	}
+
+	TUniquePtr<FGridReachability> entry = MoveTemp(entries[recycled]);
+	entries.RemoveAt(recycled, 1, false);
+	return entry;
+}
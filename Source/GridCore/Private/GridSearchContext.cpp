@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridSearchContext.h"
+#include "GridStats.h"
+#include "Algo/Reverse.h"
+
+FGridSearchContext::FGridSearchContext()
+	: generation(0)
+	, nodesExpanded(0)
+{
+}
+
+void FGridSearchContext::Begin(int32 numTiles_)
+{
+	nodesExpanded = 0;
+	if (stamps.Num() != numTiles_ || generation >= MAX_uint32 - 2)
+	{
+		//New grid size or the counter is about to wrap, pay for one full clear
+		stamps.Init(0, numTiles_);
+		gCost.SetNumUninitialized(numTiles_);
+		parentTile.SetNumUninitialized(numTiles_);
+		open.Init(numTiles_);
+		generation = 0;
+	}
+	else
+	{
+		open.Reset();
+	}
+
+	//Generations go up in steps of 2 since each search uses two stamp values
+	generation += 2;
+}
+
+void FGridSearchContext::BuildPath(int32 start_, int32 goal_, TArray<int32>& outPath_) const
+{
+	outPath_.Reset();
+	for (int32 tile = goal_; tile != start_ && tile != INDEX_NONE; tile = GetParent(tile))
+	{
+		outPath_.Add(tile);
+	}
+	Algo::Reverse(outPath_);
+}
+
+void FGridSearchContext::ReportStats() const
+{
+	INC_DWORD_STAT_BY(STAT_GridNodesExpanded, nodesExpanded);
+	SET_DWORD_STAT(STAT_GridOpenListPeak, open.GetPeak());
+}
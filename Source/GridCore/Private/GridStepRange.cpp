@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridStepRange.h"
+#include "GridStats.h"
+
+namespace
+{
+	//64 bits of a packed bitset starting at any bit
+	FORCEINLINE uint64 ReadBits(const TArray<uint64>& words_, int64 bit_)
+	{
+		const int32 word = (int32)(bit_ >> 6);
+		const int32 shift = (int32)(bit_ & 63);
+		uint64 bits = words_[word] >> shift;
+		if (shift != 0 && word + 1 < words_.Num())
+		{
+			bits |= words_[word + 1] << (64 - shift);
+		}
+		return bits;
+	}
+
+	FORCEINLINE void OrBits(TArray<uint64>& words_, int64 bit_, uint64 bits_)
+	{
+		const int32 word = (int32)(bit_ >> 6);
+		const int32 shift = (int32)(bit_ & 63);
+		words_[word] |= bits_ << shift;
+		if (shift != 0 && word + 1 < words_.Num())
+		{
+			words_[word + 1] |= bits_ >> (64 - shift);
+		}
+	}
+}
+
+FGridStepRange::FGridStepRange()
+	: origin(INDEX_NONE)
+	, maxSteps(0)
+	, version(0)
+{
+}
+
+void FGridStepRange::Reset()
+{
+	origin = INDEX_NONE;
+	maxSteps = 0;
+	version = 0;
+	mask.Init(0, false);
+}
+
+void FGridStepRange::Compute(const FGridMap& grid_, int32 origin_, int32 maxSteps_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridStepRange);
+	Reset();
+	if (!grid_.IsValidIndex(origin_))
+		return;
+
+	origin = origin_;
+	maxSteps = FMath::Max(maxSteps_, 0);
+	version = grid_.GetVersion();
+	mask.Init(grid_.Num(), false);
+
+	//Window of the tiles that are at most maxSteps away in both directions
+	const int32 width = grid_.GetWidth();
+	const int32 originX = grid_.GetX(origin_);
+	const int32 originY = grid_.GetY(origin_);
+	const int32 minY = FMath::Max(originY - maxSteps, 0);
+	const int32 maxY = FMath::Min(originY + maxSteps, grid_.GetHeight() - 1);
+	const int32 minWord = FMath::Max(originX - maxSteps, 0) >> 6;
+	const int32 maxWord = FMath::Min(originX + maxSteps, width - 1) >> 6;
+	const int32 rows = maxY - minY + 1;
+	const int32 stride = maxWord - minWord + 1;
+
+	//Rows of the window with bits past the end of the grid row left at 0, so shifts never leak into them
+	const TArray<uint64>& traversable = grid_.GetTraversableMask().GetWords();
+	open.SetNumUninitialized(rows * stride);
+	reached.SetNumZeroed(rows * stride);
+	dilated.SetNumUninitialized(rows * stride);
+	for (int32 r = 0; r < rows; r++)
+	{
+		const int64 rowStart = (int64)(minY + r) * width;
+		for (int32 w = 0; w < stride; w++)
+		{
+			const int32 x = (minWord + w) << 6;
+			const int32 bits = FMath::Min(width - x, 64);
+			const uint64 rowMask = bits == 64 ? ~0ull : (1ull << bits) - 1;
+			open[r * stride + w] = ReadBits(traversable, rowStart + x) & rowMask;
+		}
+	}
+
+	const int32 originRow = originY - minY;
+	const int32 originBit = originX - (minWord << 6);
+	reached[originRow * stride + (originBit >> 6)] |= 1ull << (originBit & 63);
+
+	//Rows reached tiles were added to on the last step. Only they and the rows next to them can grow
+	int32 changedMin = originRow;
+	int32 changedMax = originRow;
+	for (int32 step = 0; step < maxSteps && changedMin <= changedMax; step++)
+	{
+		//Spread the changed rows sideways first, so every row below reads the reached tiles from before this step
+		for (int32 r = changedMin; r <= changedMax; r++)
+		{
+			const uint64* row = &reached[r * stride];
+			uint64* out = &dilated[r * stride];
+			for (int32 w = 0; w < stride; w++)
+			{
+				const uint64 left = w > 0 ? row[w - 1] >> 63 : 0;
+				const uint64 right = w + 1 < stride ? row[w + 1] << 63 : 0;
+				out[w] = row[w] | (row[w] << 1) | (row[w] >> 1) | left | right;
+			}
+		}
+
+		const int32 fromRow = FMath::Max(changedMin - 1, 0);
+		const int32 toRow = FMath::Min(changedMax + 1, rows - 1);
+		const int32 previousMin = changedMin;
+		const int32 previousMax = changedMax;
+		changedMin = MAX_int32;
+		changedMax = -1;
+		for (int32 r = fromRow; r <= toRow; r++)
+		{
+			uint64* row = &reached[r * stride];
+			const uint64* openRow = &open[r * stride];
+			const uint64* below = r - 1 >= previousMin && r - 1 <= previousMax ? &dilated[(r - 1) * stride] : nullptr;
+			const uint64* same = r >= previousMin && r <= previousMax ? &dilated[r * stride] : nullptr;
+			const uint64* above = r + 1 >= previousMin && r + 1 <= previousMax ? &dilated[(r + 1) * stride] : nullptr;
+
+			uint64 grown = 0;
+			for (int32 w = 0; w < stride; w++)
+			{
+				const uint64 spread = (below ? below[w] : 0) | (same ? same[w] : 0) | (above ? above[w] : 0);
+				const uint64 added = spread & openRow[w] & ~row[w];
+				row[w] |= added;
+				grown |= added;
+			}
+			if (grown != 0)
+			{
+				changedMin = FMath::Min(changedMin, r);
+				changedMax = FMath::Max(changedMax, r);
+			}
+		}
+	}
+
+	//Back to grid index order
+	TArray<uint64>& maskWords = mask.GetWords();
+	for (int32 r = 0; r < rows; r++)
+	{
+		const int64 rowStart = (int64)(minY + r) * width;
+		for (int32 w = 0; w < stride; w++)
+		{
+			if (reached[r * stride + w] != 0)
+			{
+				OrBits(maskWords, rowStart + ((minWord + w) << 6), reached[r * stride + w]);
+			}
+		}
+	}
+}
@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridVisibility.h"
+#include "GridStats.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	//Below this many queries the batch isn't worth waking the worker threads for
+	const int32 MinParallelQueries = 64;
+
+	FORCEINLINE bool BlocksSight(const FGridMap& grid_, int32 x_, int32 y_)
+	{
+		return !grid_.IsValid(x_, y_) || !grid_.IsTraversable(grid_.ToIndex(x_, y_));
+	}
+}
+
+FGridVisibility::FGridVisibility()
+	: origin(INDEX_NONE)
+	, radius(0)
+	, version(0)
+{
+}
+
+void FGridVisibility::Reset()
+{
+	origin = INDEX_NONE;
+	radius = 0;
+	version = 0;
+	mask.Init(0, false);
+}
+
+void FGridVisibility::Compute(const FGridMap& grid_, int32 origin_, int32 radius_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridVisibility);
+	Reset();
+	if (!grid_.IsValidIndex(origin_))
+		return;
+
+	origin = origin_;
+	radius = FMath::Max(radius_, 0);
+	version = grid_.GetVersion();
+	mask.Init(grid_.Num(), false);
+	mask.Set(origin_, true);
+
+	static const int32 Multipliers[4][8] =
+	{
+		{ 1, 0, 0, -1, -1, 0, 0, 1 },
+		{ 0, 1, -1, 0, 0, -1, 1, 0 },
+		{ 0, 1, 1, 0, 0, -1, -1, 0 },
+		{ 1, 0, 0, 1, -1, 0, 0, -1 }
+	};
+	for (int32 octant = 0; octant < 8; octant++)
+	{
+		CastLight(grid_, 1, 1.0f, 0.0f, Multipliers[0][octant], Multipliers[1][octant], Multipliers[2][octant], Multipliers[3][octant]);
+	}
+}
+
+void FGridVisibility::CastLight(const FGridMap& grid_, int32 row_, float start_, float end_, int32 xx_, int32 xy_, int32 yx_, int32 yy_)
+{
+	if (start_ < end_)
+		return;
+
+	const int32 originX = grid_.GetX(origin);
+	const int32 originY = grid_.GetY(origin);
+	const int32 radiusSquared = radius * radius;
+	float nextStart = 0.0f;
+	for (int32 j = row_; j <= radius; j++)
+	{
+		const int32 dy = -j;
+		bool bBlocked = false;
+		for (int32 dx = -j; dx <= 0; dx++)
+		{
+			//Slopes of the tile's left and right edges as seen from the origin
+			const float leftSlope = (dx - 0.5f) / (dy + 0.5f);
+			const float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+			if (start_ < rightSlope)
+				continue;
+			if (end_ > leftSlope)
+				break;
+
+			const int32 x = originX + dx * xx_ + dy * xy_;
+			const int32 y = originY + dx * yx_ + dy * yy_;
+			if (dx * dx + dy * dy <= radiusSquared && grid_.IsValid(x, y))
+			{
+				mask.Set(grid_.ToIndex(x, y), true);
+			}
+
+			const bool bBlocks = BlocksSight(grid_, x, y);
+			if (bBlocked)
+			{
+				//Still in the shadow of the blocking tiles, or back in the light
+				if (bBlocks)
+				{
+					nextStart = rightSlope;
+					continue;
+				}
+				bBlocked = false;
+				start_ = nextStart;
+				//The shadows covered the rest of the cone, going on would light tiles outside it
+				if (start_ < end_)
+					return;
+			}
+			else if (bBlocks && j < radius)
+			{
+				//Everything before the blocking tile is scanned separately and the rest of the row continues after it
+				bBlocked = true;
+				CastLight(grid_, j + 1, start_, leftSlope, xx_, xy_, yx_, yy_);
+				nextStart = rightSlope;
+			}
+		}
+		if (bBlocked)
+			break;
+	}
+}
+
+bool FGridVisibility::TraceLine(const FGridMap& grid_, int32 from_, int32 to_)
+{
+	int32 x = grid_.GetX(from_);
+	int32 y = grid_.GetY(from_);
+	const int32 toX = grid_.GetX(to_);
+	const int32 toY = grid_.GetY(to_);
+	const int32 dx = FMath::Abs(toX - x);
+	const int32 dy = -FMath::Abs(toY - y);
+	const int32 stepX = x < toX ? 1 : -1;
+	const int32 stepY = y < toY ? 1 : -1;
+	int32 error = dx + dy;
+	while (true)
+	{
+		const int32 doubleError = 2 * error;
+		if (doubleError >= dy)
+		{
+			error += dy;
+			x += stepX;
+		}
+		if (doubleError <= dx)
+		{
+			error += dx;
+			y += stepY;
+		}
+		if (x == toX && y == toY)
+			return true;
+		if (!grid_.IsTraversable(grid_.ToIndex(x, y)))
+			return false;
+	}
+}
+
+bool FGridVisibility::HasLineOfSight(const FGridMap& grid_, int32 from_, int32 to_)
+{
+	if (!grid_.IsValidIndex(from_) || !grid_.IsValidIndex(to_))
+		return false;
+	if (from_ == to_)
+		return true;
+	return TraceLine(grid_, from_, to_) || TraceLine(grid_, to_, from_);
+}
+
+void FGridVisibility::HasLineOfSight(const FGridMap& grid_, const TArray<FGridSightQuery>& queries_, TArray<bool>& outVisible_)
+{
+	outVisible_.SetNumUninitialized(queries_.Num());
+	ParallelFor(queries_.Num(), [&](int32 i_)
+	{
+		outVisible_[i_] = HasLineOfSight(grid_, queries_[i_].from, queries_[i_].to);
+	}, queries_.Num() < MinParallelQueries);
+}
+
+void FGridVisibility::Compute(const FGridMap& grid_, const TArray<int32>& origins_, int32 radius_, TArray<FGridVisibility>& outResults_)
+{
+	outResults_.SetNum(origins_.Num());
+	ParallelFor(origins_.Num(), [&](int32 i_)
+	{
+		outResults_[i_].Compute(grid_, origins_[i_], radius_);
+	});
+}
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "GridMap.h"
+#include "GridSearchContext.h"
+#include "GridAStar.h"
+#include "GridAnyAngle.h"
+#include "GridVisibility.h"
+#include "GridTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	float GetDistance(const FGridMap& grid_, int32 from_, int32 to_)
+	{
+		const float dx = (float)(grid_.GetX(to_) - grid_.GetX(from_));
+		const float dy = (float)(grid_.GetY(to_) - grid_.GetY(from_));
+		return FMath::Sqrt(dx * dx + dy * dy);
+	}
+
+	float GetLength(const FGridMap& grid_, int32 start_, const TArray<int32>& path_)
+	{
+		float length = 0.0f;
+		int32 from = start_;
+		for (int32 tile : path_)
+		{
+			length += GetDistance(grid_, from, tile);
+			from = tile;
+		}
+		return length;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridAnyAngleTest, "GridCore.AnyAngle", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridAnyAngleTest::RunTest(const FString& Parameters)
+{
+	FRandomStream random(31);
+	FGridSearchContext context;
+	TArray<int32> path;
+	TArray<int32> waypoints;
+	for (int32 round = 0; round < 30; round++)
+	{
+		FGridMap grid;
+		grid.Init(random.RandRange(2, 40), random.RandRange(2, 40));
+		GridTest::FillRandom(grid, random, round % 5 == 0 ? 0 : random.RandRange(5, 35), round % 3 == 2);
+
+		for (int32 i = 0; i < 50; i++)
+		{
+			const int32 start = random.RandHelper(grid.Num());
+			const int32 goal = random.RandHelper(grid.Num());
+			grid.SetTraversable(start, true);
+			if (!FGridAStar::FindPath(grid, context, start, goal, nullptr, path) || path.Num() == 0)
+				continue;
+
+			FGridAnyAngle::ReducePath(grid, start, path, nullptr, waypoints);
+			if (waypoints.Num() == 0 || waypoints.Last() != goal)
+			{
+				AddError(FString::Printf(TEXT("Round %d: waypoints from %d don't end at %d"), round, start, goal));
+				return false;
+			}
+
+			//Every straight segment can be seen along and the whole thing is never longer than the tile path
+			int32 from = start;
+			for (int32 waypoint : waypoints)
+			{
+				if (!FGridVisibility::HasLineOfSight(grid, from, waypoint))
+				{
+					AddError(FString::Printf(TEXT("Round %d: no line of sight from %d to waypoint %d"), round, from, waypoint));
+					return false;
+				}
+				from = waypoint;
+			}
+			if (GetLength(grid, start, waypoints) > GetLength(grid, start, path) + 0.001f)
+			{
+				AddError(FString::Printf(TEXT("Round %d: waypoints from %d to %d are longer than the path"), round, start, goal));
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,367 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "GridMap.h"
+#include "GridBitset.h"
+#include "GridIndexedHeap.h"
+#include "GridSearchContext.h"
+#include "GridAStar.h"
+#include "GridJumpPointSearch.h"
+#include "GridTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+//Run with -ExecCmds="Automation RunTests GridCore", -nullrhi is enough
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridMapTest, "GridCore.Map", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridMapTest::RunTest(const FString& Parameters)
+{
+	//Not a multiple of 64 wide so rows don't line up with bitset words
+	FGridMap grid;
+	grid.Init(70, 5);
+	TestEqual(TEXT("Num"), grid.Num(), 350);
+	TestEqual(TEXT("Traversable tiles"), grid.GetTraversableMask().CountSetBits(), 350);
+
+	for (int32 i = 0; i < grid.Num(); i++)
+	{
+		if (grid.ToIndex(grid.GetX(i), grid.GetY(i)) != i)
+		{
+			AddError(FString::Printf(TEXT("Tile %d doesn't round trip through x and y"), i));
+			break;
+		}
+	}
+	TestEqual(TEXT("Index of (3, 2)"), grid.ToIndex(3, 2), 143);
+	TestFalse(TEXT("(70, 0) is valid"), grid.IsValid(70, 0));
+	TestFalse(TEXT("(0, -1) is valid"), grid.IsValid(0, -1));
+
+	//Every direction from a corner, an edge and the middle
+	const int32 tiles[] = { grid.ToIndex(0, 0), grid.ToIndex(69, 4), grid.ToIndex(69, 2), grid.ToIndex(10, 2) };
+	for (int32 tile : tiles)
+	{
+		for (int32 dir = 0; dir < FGridMap::NumDirections; dir++)
+		{
+			const int32 x = grid.GetX(tile) + FGridMap::DirectionX[dir];
+			const int32 y = grid.GetY(tile) + FGridMap::DirectionY[dir];
+			const int32 expected = grid.IsValid(x, y) ? grid.ToIndex(x, y) : INDEX_NONE;
+			if (grid.GetNeighbor(tile, dir) != expected)
+			{
+				AddError(FString::Printf(TEXT("Neighbor %d of tile %d is %d instead of %d"), dir, tile, grid.GetNeighbor(tile, dir), expected));
+			}
+		}
+	}
+	for (int32 dir = 0; dir < FGridMap::NumDirections; dir++)
+	{
+		const bool bDiagonal = FGridMap::DirectionX[dir] != 0 && FGridMap::DirectionY[dir] != 0;
+		TestTrue(TEXT("Diagonal directions come last"), FGridMap::IsDiagonal(dir) == bDiagonal);
+	}
+
+	//Changes bump the version, setting the same value again doesn't
+	const uint32 version = grid.GetVersion();
+	grid.SetTraversable(69, false);
+	TestFalse(TEXT("Blocked tile is traversable"), grid.IsTraversable(69));
+	TestTrue(TEXT("Neighbor is traversable"), grid.IsTraversable(70));
+	TestTrue(TEXT("Version bumped by a block"), grid.GetVersion() != version);
+	const uint32 blockedVersion = grid.GetVersion();
+	grid.SetTraversable(69, false);
+	TestTrue(TEXT("Version kept by a no-op"), grid.GetVersion() == blockedVersion);
+	TestEqual(TEXT("Traversable tiles after a block"), grid.GetTraversableMask().CountSetBits(), 349);
+
+	//Costs and the estimate follow the cheapest terrain
+	TestEqual(TEXT("Straight step"), grid.GetStepCost(0, 1, false), GridCost::Straight);
+	TestEqual(TEXT("Diagonal step"), grid.GetStepCost(0, 71, true), GridCost::Diagonal);
+	TestTrue(TEXT("Uniform terrain"), grid.HasUniformTerrain());
+	grid.SetTerrainCost(1, 30);
+	TestEqual(TEXT("Step onto mud"), grid.GetStepCost(0, 1, false), 20);
+	TestFalse(TEXT("Uniform terrain after mud"), grid.HasUniformTerrain());
+	grid.SetTerrainCost(2, 5);
+	TestEqual(TEXT("Cheapest terrain"), (int32)grid.GetMinTerrainCost(), 5);
+	TestEqual(TEXT("Estimate over the cheapest terrain"), grid.GetDistanceEstimate(0, grid.ToIndex(4, 2)), (2 * GridCost::Diagonal + 2 * GridCost::Straight) / 2);
+	grid.SetTerrainCost(2, GridCost::DefaultTerrain);
+	TestEqual(TEXT("Cheapest terrain once the road is gone"), (int32)grid.GetMinTerrainCost(), (int32)GridCost::DefaultTerrain);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridBitsetTest, "GridCore.Bitset", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridBitsetTest::RunTest(const FString& Parameters)
+{
+	FGridBitset bits;
+	bits.Init(130, true);
+	TestEqual(TEXT("Words"), bits.GetWords().Num(), 3);
+	TestEqual(TEXT("Set bits"), bits.CountSetBits(), 130);
+	TestTrue(TEXT("Padding is clear"), bits.GetWords().Last() == 3ull);
+
+	bits.SetAll(false);
+	TestEqual(TEXT("Set bits after clearing"), bits.CountSetBits(), 0);
+	TestEqual(TEXT("Next bit of an empty set"), bits.FindNextSetBit(0), INDEX_NONE);
+	bits.SetAll(true);
+	TestEqual(TEXT("Set bits after setting all"), bits.CountSetBits(), 130);
+
+	//Bits on both sides of the word boundaries
+	bits.SetAll(false);
+	const int32 setBits[] = { 0, 63, 64, 127, 129 };
+	for (int32 bit : setBits)
+	{
+		bits.Set(bit, true);
+	}
+	TestEqual(TEXT("Set bits"), bits.CountSetBits(), 5);
+	TestEqual(TEXT("Next from 0"), bits.FindNextSetBit(0), 0);
+	TestEqual(TEXT("Next from 1"), bits.FindNextSetBit(1), 63);
+	TestEqual(TEXT("Next from 64"), bits.FindNextSetBit(64), 64);
+	TestEqual(TEXT("Next from 65"), bits.FindNextSetBit(65), 127);
+	TestEqual(TEXT("Next from 128"), bits.FindNextSetBit(128), 129);
+	TestEqual(TEXT("Next past the end"), bits.FindNextSetBit(130), INDEX_NONE);
+	bits.Set(129, false);
+	TestEqual(TEXT("Next after the last is cleared"), bits.FindNextSetBit(128), INDEX_NONE);
+	TestTrue(TEXT("Get 63"), bits.Get(63));
+	TestFalse(TEXT("Get 62"), bits.Get(62));
+
+	//Copying words in drops the padding bits
+	const uint64 words[] = { ~0ull, ~0ull };
+	FGridBitset copy;
+	copy.Init(70, words);
+	TestEqual(TEXT("Set bits of a copy"), copy.CountSetBits(), 70);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridIndexedHeapTest, "GridCore.IndexedHeap", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridIndexedHeapTest::RunTest(const FString& Parameters)
+{
+	const int32 numItems = 500;
+	FRandomStream random(7);
+	FGridIndexedHeap heap;
+	heap.Init(numItems);
+
+	for (int32 round = 0; round < 4; round++)
+	{
+		//Expected key of every item, INDEX_NONE when it's not in the heap
+		TArray<int64> keys;
+		keys.Init(INDEX_NONE, numItems);
+		for (int32 i = 0; i < numItems; i++)
+		{
+			if (random.RandHelper(3) != 0)
+			{
+				keys[i] = random.RandRange(0, 1000);
+				heap.Push(i, keys[i]);
+			}
+		}
+
+		//Decrease some keys, raise a few, drop a few
+		for (int32 i = 0; i < numItems; i++)
+		{
+			if (keys[i] == INDEX_NONE)
+				continue;
+
+			const int32 change = random.RandHelper(5);
+			if (change == 0)
+			{
+				keys[i] -= random.RandRange(1, 500);
+				heap.Update(i, keys[i]);
+			}
+			else if (change == 1)
+			{
+				keys[i] += random.RandRange(1, 500);
+				heap.Update(i, keys[i]);
+			}
+			else if (change == 2)
+			{
+				keys[i] = INDEX_NONE;
+				heap.Remove(i);
+			}
+		}
+
+		int32 expectedNum = 0;
+		for (int32 i = 0; i < numItems; i++)
+		{
+			if (heap.Contains(i) != (keys[i] != INDEX_NONE))
+			{
+				AddError(FString::Printf(TEXT("Round %d: item %d is in the heap when it shouldn't be or the other way around"), round, i));
+				return false;
+			}
+			if (keys[i] != INDEX_NONE)
+			{
+				expectedNum++;
+				if (heap.GetKey(i) != keys[i])
+				{
+					AddError(FString::Printf(TEXT("Round %d: item %d has the wrong key"), round, i));
+					return false;
+				}
+			}
+		}
+		TestEqual(TEXT("Items in the heap"), heap.Num(), expectedNum);
+
+		//Pop half of them in key order, then let Reset drop the rest
+		int64 lastKey = MIN_int64;
+		for (int32 i = 0; i < expectedNum / 2; i++)
+		{
+			const int64 topKey = heap.TopKey();
+			const int32 item = heap.Pop();
+			if (topKey < lastKey || keys[item] != topKey || heap.Contains(item))
+			{
+				AddError(FString::Printf(TEXT("Round %d: pop %d returned item %d out of order"), round, i, item));
+				return false;
+			}
+			lastKey = topKey;
+		}
+		TestTrue(TEXT("Peak covers the pushes"), heap.GetPeak() >= expectedNum);
+		heap.Reset();
+		TestTrue(TEXT("Empty after a reset"), heap.IsEmpty());
+		for (int32 i = 0; i < numItems; i++)
+		{
+			if (heap.Contains(i))
+			{
+				AddError(FString::Printf(TEXT("Round %d: item %d survived the reset"), round, i));
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridSearchContextTest, "GridCore.SearchContext", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridSearchContextTest::RunTest(const FString& Parameters)
+{
+	FRandomStream random(11);
+	FGridMap grid;
+	grid.Init(24, 24);
+	GridTest::FillRandom(grid, random, 25, true);
+	const int32 start = grid.ToIndex(0, 0);
+	grid.SetTraversable(start, true);
+
+	TArray<int32> costs;
+	GridTest::ComputeCosts(grid, start, costs);
+
+	//Start a few searches short of the wrap so the last ones run right after the full clear
+	FGridSearchContext context;
+	context.Begin(grid.Num());
+	context.SetGenerationForTesting(MAX_uint32 - 11);
+	TArray<int32> path;
+	for (int32 search = 0; search < 8; search++)
+	{
+		const uint32 lastGeneration = context.GetGenerationForTesting();
+		const int32 goal = random.RandHelper(grid.Num());
+		const bool bFound = FGridAStar::FindPath(grid, context, start, goal, nullptr, path);
+		const uint32 generation = context.GetGenerationForTesting();
+
+		if (search > 0 && generation <= lastGeneration && generation != 2)
+		{
+			AddError(FString::Printf(TEXT("Search %d: generation went from %u to %u"), search, lastGeneration, generation));
+		}
+		//Generation + 1 marks closed tiles so it can't be allowed to overflow
+		TestTrue(TEXT("Closed stamp fits"), generation < MAX_uint32);
+
+		const bool bReachable = costs[goal] != MAX_int32;
+		if (bFound != bReachable || (bFound && GridTest::GetPathCost(grid, start, path) != costs[goal]))
+		{
+			AddError(FString::Printf(TEXT("Search %d at generation %u: wrong path to %d"), search, generation, goal));
+		}
+	}
+	TestTrue(TEXT("The generation wrapped"), context.GetGenerationForTesting() < MAX_uint32 - 11);
+
+	//Nothing a search left behind can look visited once the next one begins, wrap or not
+	context.SetGenerationForTesting(MAX_uint32 - 3);
+	for (int32 search = 0; search < 3; search++)
+	{
+		for (int32 i = 0; i < grid.Num(); i++)
+		{
+			context.Visit(i, 1, INDEX_NONE);
+			if (i % 2 == 0)
+			{
+				context.Close(i);
+			}
+		}
+		context.Begin(grid.Num());
+		for (int32 i = 0; i < grid.Num(); i++)
+		{
+			if (context.IsVisited(i) || context.IsClosed(i) || context.GetParent(i) != INDEX_NONE)
+			{
+				AddError(FString::Printf(TEXT("Tile %d is still visited at generation %u"), i, context.GetGenerationForTesting()));
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridAStarTest, "GridCore.AStar", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridAStarTest::RunTest(const FString& Parameters)
+{
+	FRandomStream random(3);
+	FGridSearchContext context;
+	TArray<int32> path;
+	TArray<int32> costs;
+	for (int32 round = 0; round < 20; round++)
+	{
+		FGridMap grid;
+		grid.Init(random.RandRange(1, 40), random.RandRange(1, 40));
+		GridTest::FillRandom(grid, random, random.RandRange(0, 40), round % 2 == 1);
+		const int32 start = random.RandHelper(grid.Num());
+		grid.SetTraversable(start, true);
+		GridTest::ComputeCosts(grid, start, costs);
+
+		for (int32 goal = 0; goal < grid.Num(); goal++)
+		{
+			const bool bFound = FGridAStar::FindPath(grid, context, start, goal, nullptr, path);
+			if (bFound != (costs[goal] != MAX_int32) || (bFound && GridTest::GetPathCost(grid, start, path) != costs[goal]))
+			{
+				AddError(FString::Printf(TEXT("Round %d: wrong path from %d to %d on a %dx%d grid"), round, start, goal, grid.GetWidth(), grid.GetHeight()));
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridJumpPointTest, "GridCore.JumpPoint", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridJumpPointTest::RunTest(const FString& Parameters)
+{
+	//Jumps on open and blocked boards, on uniform terrain that isn't the default, and mixed terrain where it falls back to A*
+	FRandomStream random(19);
+	FGridSearchContext context;
+	TArray<int32> path;
+	TArray<int32> costs;
+	for (int32 round = 0; round < 24; round++)
+	{
+		FGridMap grid;
+		grid.Init(random.RandRange(1, 40), random.RandRange(1, 40));
+		GridTest::FillRandom(grid, random, round % 4 == 0 ? 0 : random.RandRange(5, 45), round % 3 == 2);
+		if (round % 3 == 1)
+		{
+			for (int32 i = 0; i < grid.Num(); i++)
+			{
+				grid.SetTerrainCost(i, 15);
+			}
+		}
+		const int32 start = random.RandHelper(grid.Num());
+		grid.SetTraversable(start, true);
+		GridTest::ComputeCosts(grid, start, costs);
+
+		for (int32 goal = 0; goal < grid.Num(); goal++)
+		{
+			const bool bFound = FGridJumpPointSearch::FindPath(grid, context, start, goal, nullptr, path);
+			const int32 cost = bFound ? GridTest::GetPathCost(grid, start, path) : MAX_int32;
+			const bool bEndsAtGoal = !bFound || (path.Num() > 0 ? path.Last() == goal : start == goal);
+			if (cost != costs[goal] || !bEndsAtGoal)
+			{
+				AddError(FString::Printf(TEXT("Round %d: wrong path from %d to %d on a %dx%d grid%s"), round, start, goal, grid.GetWidth(), grid.GetHeight(),
+					grid.HasUniformTerrain() ? TEXT("") : TEXT(" with mixed terrain")));
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
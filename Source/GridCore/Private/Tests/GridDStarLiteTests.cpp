@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "GridMap.h"
+#include "GridSearchContext.h"
+#include "GridAStar.h"
+#include "GridDStarLite.h"
+#include "GridTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridDStarLiteTest, "GridCore.DStarLite", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridDStarLiteTest::RunTest(const FString& Parameters)
+{
+	FRandomStream random(13);
+	FGridSearchContext context;
+	TArray<int32> path;
+	TArray<int32> flatPath;
+
+	for (int32 board = 0; board < 4; board++)
+	{
+		FGridMap grid;
+		grid.Init(32, 32);
+		GridTest::FillRandom(grid, random, 25, board % 2 == 1);
+		int32 start = random.RandHelper(grid.Num());
+		const int32 goal = random.RandHelper(grid.Num());
+		grid.SetTraversable(start, true);
+		grid.SetTraversable(goal, true);
+
+		FGridDStarLite dStar;
+		dStar.Init(grid, start, goal);
+		int32 roadY = 0;
+
+		for (int32 round = 0; round < 40; round++)
+		{
+			//Flip some tiles, and now and then change terrain, moving the cheapest cost down and back up
+			//which makes D* Lite start over since its heuristic isn't admissible anymore
+			for (int32 i = 0; i < 8; i++)
+			{
+				const int32 tile = random.RandHelper(grid.Num());
+				if (tile != start && tile != goal)
+				{
+					grid.SetTraversable(tile, !grid.IsTraversable(tile));
+					dStar.NotifyTileChanged(grid, tile);
+				}
+			}
+			if (round % 5 == 0)
+			{
+				const int32 tile = random.RandHelper(grid.Num());
+				grid.SetTerrainCost(tile, (uint8)random.RandRange(12, 40));
+				dStar.NotifyTileChanged(grid, tile);
+			}
+			if (round % 10 == 3)
+			{
+				//A road across the board that paths want to take
+				roadY = random.RandHelper(grid.GetHeight());
+				for (int32 x = 0; x < grid.GetWidth(); x++)
+				{
+					const int32 tile = grid.ToIndex(x, roadY);
+					grid.SetTerrainCost(tile, 3);
+					dStar.NotifyTileChanged(grid, tile);
+				}
+				TestEqual(TEXT("Cheapest terrain"), (int32)grid.GetMinTerrainCost(), 3);
+			}
+			else if (round % 10 == 7)
+			{
+				for (int32 x = 0; x < grid.GetWidth(); x++)
+				{
+					const int32 tile = grid.ToIndex(x, roadY);
+					grid.SetTerrainCost(tile, GridCost::DefaultTerrain);
+					dStar.NotifyTileChanged(grid, tile);
+				}
+			}
+
+			const bool bFlat = FGridAStar::FindPath(grid, context, start, goal, nullptr, flatPath);
+			const bool bFound = dStar.FindPath(grid, path);
+			const int32 cost = bFound ? GridTest::GetPathCost(grid, start, path) : INDEX_NONE;
+			const int32 flatCost = bFlat ? GridTest::GetPathCost(grid, start, flatPath) : INDEX_NONE;
+			if (bFound != bFlat || cost != flatCost || (bFound && path.Num() > 0 && path.Last() != goal))
+			{
+				AddError(FString::Printf(TEXT("Board %d round %d: D* Lite path from %d to %d costs %d, A* %d"), board, round, start, goal, cost, flatCost));
+				break;
+			}
+
+			//Walk a step along the path like a unit would
+			if (bFound && path.Num() > 1 && round % 2 == 0)
+			{
+				start = path[0];
+				dStar.SetStart(grid, start);
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "GridMap.h"
+#include "GridSearchContext.h"
+#include "GridFlowField.h"
+#include "GridTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridFlowFieldTest, "GridCore.FlowField", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridFlowFieldTest::RunTest(const FString& Parameters)
+{
+	FRandomStream random(23);
+	FGridSearchContext context;
+	FGridFlowField field;
+	TArray<int32> costs;
+	TArray<int32> path;
+	for (int32 round = 0; round < 16; round++)
+	{
+		FGridMap grid;
+		grid.Init(random.RandRange(1, 40), random.RandRange(1, 40));
+		GridTest::FillRandom(grid, random, random.RandRange(0, 40), round % 2 == 1);
+		const int32 goal = random.RandHelper(grid.Num());
+		grid.SetTraversable(goal, true);
+
+		field.Build(grid, context, goal);
+		GridTest::ComputeCosts(grid, goal, costs);
+		TestTrue(TEXT("Field is on the grid's version"), field.GetVersion() == grid.GetVersion());
+
+		for (int32 tile = 0; tile < grid.Num(); tile++)
+		{
+			if (field.GetCost(tile) != costs[tile])
+			{
+				AddError(FString::Printf(TEXT("Round %d: tile %d costs %d to reach %d instead of %d"), round, tile, field.GetCost(tile), goal, costs[tile]));
+				return false;
+			}
+			if (!field.IsReachable(tile))
+			{
+				if (field.GetDirection(tile) != FGridFlowField::NoDirection || field.GetPath(tile, path))
+				{
+					AddError(FString::Printf(TEXT("Round %d: unreachable tile %d has a way to %d"), round, tile, goal));
+					return false;
+				}
+				continue;
+			}
+
+			//Walking the directions has to get there for exactly the cost the field promises
+			const bool bFound = field.GetPath(tile, path);
+			const bool bEndsAtGoal = path.Num() > 0 ? path.Last() == goal : tile == goal;
+			if (!bFound || !bEndsAtGoal || GridTest::GetPathCost(grid, tile, path) != costs[tile])
+			{
+				AddError(FString::Printf(TEXT("Round %d: following the field from %d doesn't reach %d for its cost"), round, tile, goal));
+				return false;
+			}
+			const int32 next = field.GetNextTile(tile);
+			if (tile == goal ? next != INDEX_NONE : next != path[0])
+			{
+				AddError(FString::Printf(TEXT("Round %d: next tile of %d doesn't match its path"), round, tile));
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,272 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "GridMap.h"
+#include "GridSearchContext.h"
+#include "GridAStar.h"
+#include "GridHierarchy.h"
+#include "GridTestHelpers.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/BufferReader.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	//HPA* has to find a path exactly when A* does, and it has to be a real path no cheaper than A*'s
+	bool CheckAllGoals(FAutomationTestBase& test_, const FGridMap& grid_, const FGridHierarchy& hierarchy_, int32 start_, const TCHAR* case_)
+	{
+		FGridSearchContext context;
+		TArray<int32> path;
+		TArray<int32> flatPath;
+		for (int32 goal = 0; goal < grid_.Num(); goal++)
+		{
+			const bool bFlat = FGridAStar::FindPath(grid_, context, start_, goal, nullptr, flatPath);
+			const bool bFound = hierarchy_.FindPath(grid_, context, start_, goal, path);
+			if (bFound != bFlat)
+			{
+				test_.AddError(FString::Printf(TEXT("%s: HPA* %s a path from %d to %d and A* %s"), case_,
+					bFound ? TEXT("found") : TEXT("didn't find"), start_, goal, bFlat ? TEXT("did") : TEXT("didn't")));
+				return false;
+			}
+			if (!bFound)
+				continue;
+
+			const int32 cost = GridTest::GetPathCost(grid_, start_, path);
+			const bool bEndsAtGoal = path.Num() > 0 ? path.Last() == goal : start_ == goal;
+			if (cost == INDEX_NONE || !bEndsAtGoal || cost < GridTest::GetPathCost(grid_, start_, flatPath))
+			{
+				test_.AddError(FString::Printf(TEXT("%s: HPA* path from %d to %d isn't valid"), case_, start_, goal));
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void BlockAll(FGridMap& grid_)
+	{
+		for (int32 i = 0; i < grid_.Num(); i++)
+		{
+			grid_.SetTraversable(i, false);
+		}
+	}
+
+	void OpenRect(FGridMap& grid_, int32 minX_, int32 minY_, int32 maxX_, int32 maxY_)
+	{
+		for (int32 y = minY_; y <= maxY_; y++)
+		{
+			for (int32 x = minX_; x <= maxX_; x++)
+			{
+				grid_.SetTraversable(grid_.ToIndex(x, y), true);
+			}
+		}
+	}
+
+	bool Load(FGridHierarchy& hierarchy_, TArray<uint8>& data_)
+	{
+		FBufferReader reader(data_.GetData(), data_.Num(), false);
+		hierarchy_.Serialize(reader);
+		return !reader.IsError();
+	}
+
+	void SetInt(TArray<uint8>& data_, int32 offset_, int32 value_)
+	{
+		FMemory::Memcpy(data_.GetData() + offset_, &value_, sizeof(value_));
+	}
+
+	int32 GetInt(const TArray<uint8>& data_, int32 offset_)
+	{
+		int32 value;
+		FMemory::Memcpy(&value, data_.GetData() + offset_, sizeof(value));
+		return value;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridHierarchyTest, "GridCore.Hierarchy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridHierarchyTest::RunTest(const FString& Parameters)
+{
+	const int32 clusterSize = 4;
+
+	//The only way between the two open clusters is the diagonal step over their shared corner
+	{
+		FGridMap grid;
+		grid.Init(8, 8);
+		BlockAll(grid);
+		OpenRect(grid, 0, 0, 3, 3);
+		OpenRect(grid, 4, 4, 7, 7);
+		FGridHierarchy hierarchy;
+		hierarchy.Build(grid, clusterSize);
+		CheckAllGoals(*this, grid, hierarchy, grid.ToIndex(0, 0), TEXT("Corner crossing"));
+	}
+
+	//A straight border that can only be crossed diagonally, between two rooms that don't face each other
+	{
+		FGridMap grid;
+		grid.Init(10, 6);
+		BlockAll(grid);
+		OpenRect(grid, 0, 0, 3, 1);
+		OpenRect(grid, 4, 2, 9, 3);
+		FGridHierarchy hierarchy;
+		hierarchy.Build(grid, clusterSize);
+		CheckAllGoals(*this, grid, hierarchy, grid.ToIndex(0, 0), TEXT("Diagonal border crossing"));
+		CheckAllGoals(*this, grid, hierarchy, grid.ToIndex(9, 3), TEXT("Diagonal border crossing back"));
+	}
+
+	//Random boards that don't divide into whole clusters, then again after blocking and opening tiles
+	FRandomStream random(5);
+	for (int32 round = 0; round < 12; round++)
+	{
+		FGridMap grid;
+		grid.Init(random.RandRange(5, 30), random.RandRange(5, 30));
+		GridTest::FillRandom(grid, random, random.RandRange(10, 45), round % 3 == 2);
+		const int32 start = random.RandHelper(grid.Num());
+		grid.SetTraversable(start, true);
+
+		FGridHierarchy hierarchy;
+		hierarchy.Build(grid, clusterSize);
+		const FString name = FString::Printf(TEXT("Round %d"), round);
+		if (!CheckAllGoals(*this, grid, hierarchy, start, *name))
+			continue;
+
+		for (int32 i = 0; i < grid.Num() / 10; i++)
+		{
+			const int32 tile = random.RandHelper(grid.Num());
+			if (tile != start)
+			{
+				grid.SetTraversable(tile, !grid.IsTraversable(tile));
+				hierarchy.MarkTileChanged(grid, tile);
+			}
+		}
+		hierarchy.Update(grid);
+		const FString updatedName = FString::Printf(TEXT("Round %d after an update"), round);
+		CheckAllGoals(*this, grid, hierarchy, start, *updatedName);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridHierarchySerializeTest, "GridCore.HierarchySerialize", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridHierarchySerializeTest::RunTest(const FString& Parameters)
+{
+	const int32 clusterSize = 4;
+	//Serialize starts with clusterSize, clustersX, clustersY and the two counts, then five ints per node
+	const int32 NodesOffset = 5 * sizeof(int32);
+	const int32 NodeSize = 5 * sizeof(int32);
+
+	FRandomStream random(17);
+	for (int32 round = 0; round < 8; round++)
+	{
+		FGridMap grid;
+		grid.Init(random.RandRange(5, 30), random.RandRange(5, 30));
+		GridTest::FillRandom(grid, random, random.RandRange(10, 40), round % 2 == 1);
+		const int32 start = random.RandHelper(grid.Num());
+		grid.SetTraversable(start, true);
+
+		FGridHierarchy hierarchy;
+		hierarchy.Build(grid, clusterSize);
+		//Odd rounds save after an update so the free node list isn't empty
+		if (round % 2 == 1)
+		{
+			for (int32 i = 0; i < grid.Num() / 10; i++)
+			{
+				const int32 tile = random.RandHelper(grid.Num());
+				if (tile != start)
+				{
+					grid.SetTraversable(tile, !grid.IsTraversable(tile));
+					hierarchy.MarkTileChanged(grid, tile);
+				}
+			}
+			hierarchy.Update(grid);
+		}
+
+		TArray<uint8> data;
+		FMemoryWriter writer(data);
+		hierarchy.Serialize(writer);
+
+		//A loaded hierarchy has to find the same paths as the one that was saved
+		FGridHierarchy loaded;
+		if (!Load(loaded, data) || !loaded.IsBuiltFor(grid, clusterSize))
+		{
+			AddError(FString::Printf(TEXT("Round %d: the saved hierarchy didn't load"), round));
+			continue;
+		}
+		FGridSearchContext context;
+		TArray<int32> path;
+		TArray<int32> loadedPath;
+		for (int32 goal = 0; goal < grid.Num(); goal++)
+		{
+			const bool bFound = hierarchy.FindPath(grid, context, start, goal, path);
+			const bool bLoadedFound = loaded.FindPath(grid, context, start, goal, loadedPath);
+			if (bFound != bLoadedFound || path != loadedPath)
+			{
+				AddError(FString::Printf(TEXT("Round %d: the loaded hierarchy found another path from %d to %d"), round, start, goal));
+				break;
+			}
+		}
+
+		//Every truncated buffer has to fail and leave the hierarchy empty
+		for (int32 size = 0; size < data.Num(); size += FMath::Max(1, data.Num() / 50))
+		{
+			TArray<uint8> truncated(data.GetData(), size);
+			if (Load(loaded, truncated) || loaded.IsBuilt())
+			{
+				AddError(FString::Printf(TEXT("Round %d: a buffer truncated to %d bytes loaded"), round, size));
+				break;
+			}
+		}
+
+		//Ids that point at the wrong node, slot or cluster have to be caught
+		const int32 numNodes = GetInt(data, 3 * sizeof(int32));
+		int32 node = INDEX_NONE;
+		for (int32 i = 0; i < numNodes && node == INDEX_NONE; i++)
+		{
+			if (GetInt(data, NodesOffset + i * NodeSize + sizeof(int32)) != INDEX_NONE)
+			{
+				node = i;
+			}
+		}
+		if (node != INDEX_NONE)
+		{
+			const int32 nodeOffset = NodesOffset + node * NodeSize;
+			const int32 cluster = GetInt(data, nodeOffset + sizeof(int32));
+			const int32 corruptions[][2] = {
+				{ nodeOffset + 1 * (int32)sizeof(int32), cluster + 1 },
+				{ nodeOffset + 1 * (int32)sizeof(int32), MAX_int32 },
+				{ nodeOffset + 2 * (int32)sizeof(int32), node },
+				{ nodeOffset + 2 * (int32)sizeof(int32), numNodes },
+				{ nodeOffset + 3 * (int32)sizeof(int32), -1 },
+				{ nodeOffset + 4 * (int32)sizeof(int32), GetInt(data, nodeOffset + 4 * sizeof(int32)) + 1 },
+				{ nodeOffset, -1 },
+				{ 0, clusterSize + 1 },
+			};
+			for (const int32* corruption : corruptions)
+			{
+				TArray<uint8> corrupt = data;
+				SetInt(corrupt, corruption[0], corruption[1]);
+				if (Load(loaded, corrupt) || loaded.IsBuilt())
+				{
+					AddError(FString::Printf(TEXT("Round %d: setting the int at %d to %d wasn't caught"), round, corruption[0], corruption[1]));
+				}
+			}
+		}
+
+		//Random damage can leave data that's valid but wrong. It just can't make loading or searching go out of range
+		for (int32 i = 0; i < 40; i++)
+		{
+			TArray<uint8> corrupt = data;
+			const int32 offset = random.RandHelper(data.Num() / sizeof(int32)) * sizeof(int32);
+			SetInt(corrupt, offset, random.GetBool() ? (int32)(GetInt(data, offset) + (int64)random.RandRange(-2, 2)) : (int32)random.GetUnsignedInt());
+			if (Load(loaded, corrupt) && loaded.IsBuiltFor(grid, clusterSize))
+			{
+				loaded.FindPath(grid, context, start, random.RandHelper(grid.Num()), loadedPath);
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "GridMap.h"
+#include "GridStepRange.h"
+#include "GridTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridStepRangeTest, "GridCore.StepRange", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridStepRangeTest::RunTest(const FString& Parameters)
+{
+	//Widths around the word size so rows start anywhere inside a word
+	const int32 widths[] = { 1, 7, 63, 64, 65, 130, 200 };
+	const int32 heights[] = { 1, 3, 40 };
+	const int32 stepCounts[] = { 0, 1, 2, 5, 63, 64, 65, 1000 };
+
+	FRandomStream random(17);
+	FGridStepRange range;
+	TArray<int32> steps;
+	for (int32 width : widths)
+	{
+		for (int32 height : heights)
+		{
+			FGridMap grid;
+			grid.Init(width, height);
+			GridTest::FillRandom(grid, random, 30);
+
+			//Corners, the middle of each edge and a few random tiles
+			TArray<int32> origins;
+			origins.Add(grid.ToIndex(0, 0));
+			origins.Add(grid.ToIndex(width - 1, 0));
+			origins.Add(grid.ToIndex(0, height - 1));
+			origins.Add(grid.ToIndex(width - 1, height - 1));
+			origins.Add(grid.ToIndex(width / 2, 0));
+			origins.Add(grid.ToIndex(width / 2, height - 1));
+			origins.Add(grid.ToIndex(0, height / 2));
+			origins.Add(grid.ToIndex(width - 1, height / 2));
+			for (int32 i = 0; i < 3; i++)
+			{
+				origins.Add(random.RandHelper(grid.Num()));
+			}
+
+			for (int32 origin : origins)
+			{
+				GridTest::ComputeSteps(grid, origin, steps);
+				for (int32 maxSteps : stepCounts)
+				{
+					range.Compute(grid, origin, maxSteps);
+					bool bMatches = range.IsValid() && range.GetMask().Num() == grid.Num() && range.GetVersion() == grid.GetVersion();
+					for (int32 tile = 0; tile < grid.Num() && bMatches; tile++)
+					{
+						bMatches = range.Contains(tile) == (steps[tile] != INDEX_NONE && steps[tile] <= maxSteps);
+					}
+					if (!bMatches)
+					{
+						AddError(FString::Printf(TEXT("%d steps from (%d, %d) on a %dx%d grid don't match a breadth first search"),
+							maxSteps, grid.GetX(origin), grid.GetY(origin), width, height));
+					}
+				}
+			}
+		}
+	}
+
+	range.Reset();
+	TestFalse(TEXT("Valid after a reset"), range.IsValid());
+	TestEqual(TEXT("Version after a reset"), (int32)range.GetVersion(), 0);
+	TestFalse(TEXT("Contains a tile after a reset"), range.Contains(0));
+
+	return true;
+}
+
+#endif
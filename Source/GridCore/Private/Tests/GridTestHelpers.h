@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMap.h"
+
+//Shared setup and brute force references for the GridCore automation tests
+namespace GridTest
+{
+	//Blocks about density_ percent of the tiles and gives a few of the rest another terrain cost
+	inline void FillRandom(FGridMap& grid_, FRandomStream& random_, int32 density_, bool bTerrain_ = false)
+	{
+		for (int32 i = 0; i < grid_.Num(); i++)
+		{
+			grid_.SetTraversable(i, random_.RandHelper(100) >= density_);
+			if (bTerrain_ && random_.RandHelper(4) == 0)
+			{
+				grid_.SetTerrainCost(i, (uint8)random_.RandRange(7, 30));
+			}
+		}
+	}
+
+	inline bool IsStep(const FGridMap& grid_, int32 from_, int32 to_)
+	{
+		const int32 dx = FMath::Abs(grid_.GetX(from_) - grid_.GetX(to_));
+		const int32 dy = FMath::Abs(grid_.GetY(from_) - grid_.GetY(to_));
+		return dx <= 1 && dy <= 1 && dx + dy > 0;
+	}
+
+	//Cost of walking path_ from start_, or INDEX_NONE if it isn't a walkable chain of neighbors
+	inline int32 GetPathCost(const FGridMap& grid_, int32 start_, const TArray<int32>& path_)
+	{
+		int32 cost = 0;
+		int32 from = start_;
+		for (int32 tile : path_)
+		{
+			if (!grid_.IsValidIndex(tile) || !grid_.IsTraversable(tile) || !IsStep(grid_, from, tile))
+				return INDEX_NONE;
+
+			cost += grid_.GetStepCost(from, tile, grid_.GetX(from) != grid_.GetX(tile) && grid_.GetY(from) != grid_.GetY(tile));
+			from = tile;
+		}
+		return cost;
+	}
+
+	//Cost from start_ to every tile by relaxing every step until nothing changes, MAX_int32 when unreachable.
+	//Slow but simple enough to trust, only for small grids
+	inline void ComputeCosts(const FGridMap& grid_, int32 start_, TArray<int32>& outCosts_)
+	{
+		outCosts_.Init(MAX_int32, grid_.Num());
+		outCosts_[start_] = 0;
+		bool bChanged = true;
+		while (bChanged)
+		{
+			bChanged = false;
+			for (int32 tile = 0; tile < grid_.Num(); tile++)
+			{
+				if (outCosts_[tile] == MAX_int32)
+					continue;
+
+				for (int32 dir = 0; dir < FGridMap::NumDirections; dir++)
+				{
+					const int32 next = grid_.GetNeighbor(tile, dir);
+					if (next == INDEX_NONE || !grid_.IsTraversable(next))
+						continue;
+
+					const int32 cost = outCosts_[tile] + grid_.GetStepCost(tile, next, FGridMap::IsDiagonal(dir));
+					if (cost < outCosts_[next])
+					{
+						outCosts_[next] = cost;
+						bChanged = true;
+					}
+				}
+			}
+		}
+	}
+
+	//Fewest steps from origin_ to every tile, diagonals included, INDEX_NONE when unreachable
+	inline void ComputeSteps(const FGridMap& grid_, int32 origin_, TArray<int32>& outSteps_)
+	{
+		outSteps_.Init(INDEX_NONE, grid_.Num());
+		TArray<int32> frontier;
+		outSteps_[origin_] = 0;
+		frontier.Add(origin_);
+		for (int32 i = 0; i < frontier.Num(); i++)
+		{
+			const int32 tile = frontier[i];
+			for (int32 dir = 0; dir < FGridMap::NumDirections; dir++)
+			{
+				const int32 next = grid_.GetNeighbor(tile, dir);
+				if (next != INDEX_NONE && grid_.IsTraversable(next) && outSteps_[next] == INDEX_NONE)
+				{
+					outSteps_[next] = outSteps_[tile] + 1;
+					frontier.Add(next);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "GridMap.h"
+#include "GridVisibility.h"
+#include "GridTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	struct FSlopeRange
+	{
+		float low;
+		float high;
+	};
+
+	//Whether some slope in [low_, high_] is outside every shadow. Shadows are open ranges, so their edges stay lit
+	bool IsLit(float low_, float high_, const TArray<FSlopeRange>& shadows_)
+	{
+		float slope = low_;
+		bool bMoved = true;
+		while (bMoved && slope <= high_)
+		{
+			bMoved = false;
+			for (const FSlopeRange& shadow : shadows_)
+			{
+				if (shadow.low < slope && slope < shadow.high)
+				{
+					slope = shadow.high;
+					bMoved = true;
+				}
+			}
+		}
+		return slope <= high_;
+	}
+
+	//Brute force of the shadowcasting model: a tile is visible if any slope through its square, within the octant,
+	//isn't covered by the square of a blocking tile on an earlier row. Same octants and tile slopes as FGridVisibility
+	void ComputeVisibility(const FGridMap& grid_, int32 origin_, int32 radius_, TArray<bool>& outVisible_)
+	{
+		static const int32 Multipliers[4][8] =
+		{
+			{ 1, 0, 0, -1, -1, 0, 0, 1 },
+			{ 0, 1, -1, 0, 0, -1, 1, 0 },
+			{ 0, 1, 1, 0, 0, -1, -1, 0 },
+			{ 1, 0, 0, 1, -1, 0, 0, -1 }
+		};
+
+		outVisible_.Init(false, grid_.Num());
+		outVisible_[origin_] = true;
+		TArray<FSlopeRange> shadows;
+		TArray<FSlopeRange> rowShadows;
+		for (int32 octant = 0; octant < 8; octant++)
+		{
+			shadows.Reset();
+			for (int32 j = 1; j <= radius_; j++)
+			{
+				const int32 dy = -j;
+				rowShadows.Reset();
+				for (int32 dx = -j; dx <= 0; dx++)
+				{
+					const float leftSlope = (dx - 0.5f) / (dy + 0.5f);
+					const float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+					const int32 x = grid_.GetX(origin_) + dx * Multipliers[0][octant] + dy * Multipliers[1][octant];
+					const int32 y = grid_.GetY(origin_) + dx * Multipliers[2][octant] + dy * Multipliers[3][octant];
+					if (!IsLit(FMath::Max(rightSlope, 0.0f), FMath::Min(leftSlope, 1.0f), shadows))
+						continue;
+
+					if (dx * dx + dy * dy <= radius_ * radius_ && grid_.IsValid(x, y))
+					{
+						outVisible_[grid_.ToIndex(x, y)] = true;
+					}
+					if (!grid_.IsValid(x, y) || !grid_.IsTraversable(grid_.ToIndex(x, y)))
+					{
+						rowShadows.Add({ rightSlope, leftSlope });
+					}
+				}
+				shadows.Append(rowShadows);
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridVisibilityTest, "GridCore.Visibility", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridVisibilityTest::RunTest(const FString& Parameters)
+{
+	FRandomStream random(29);
+	FGridVisibility visibility;
+	TArray<bool> visible;
+	for (int32 round = 0; round < 40; round++)
+	{
+		FGridMap grid;
+		grid.Init(random.RandRange(1, 24), random.RandRange(1, 24));
+		GridTest::FillRandom(grid, random, round % 5 == 0 ? 0 : random.RandRange(5, 40));
+
+		//Lines are the same whichever end they're traced from
+		for (int32 i = 0; i < 200; i++)
+		{
+			const int32 from = random.RandHelper(grid.Num());
+			const int32 to = random.RandHelper(grid.Num());
+			if (FGridVisibility::HasLineOfSight(grid, from, to) != FGridVisibility::HasLineOfSight(grid, to, from))
+			{
+				AddError(FString::Printf(TEXT("Round %d: line of sight from %d to %d isn't symmetric"), round, from, to));
+				return false;
+			}
+		}
+
+		const int32 origin = random.RandHelper(grid.Num());
+		const int32 radius = random.RandRange(0, 12);
+		visibility.Compute(grid, origin, radius);
+		ComputeVisibility(grid, origin, radius, visible);
+		for (int32 tile = 0; tile < grid.Num(); tile++)
+		{
+			if (visibility.Contains(tile) != visible[tile])
+			{
+				AddError(FString::Printf(TEXT("Round %d: tile (%d, %d) is %s from (%d, %d) within %d tiles"), round, grid.GetX(tile), grid.GetY(tile),
+					visible[tile] ? TEXT("not visible but should be") : TEXT("visible but shouldn't be"), grid.GetX(origin), grid.GetY(origin), radius));
+				return false;
+			}
+		}
+	}
+
+	visibility.Reset();
+	TestFalse(TEXT("Valid after a reset"), visibility.IsValid());
+	TestEqual(TEXT("Version after a reset"), (int32)visibility.GetVersion(), 0);
+
+	return true;
+}
+
+#endif
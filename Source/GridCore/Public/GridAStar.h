@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMap.h"
+#include "GridSearchContext.h"
+
+//A* over a grid map. All search state lives in the context, the grid is only read
+class GRIDCORE_API FGridAStar
+{
+public:
+	//Finds the cheapest path from start_ to goal_. outPath_ gets the tiles in walking order, without start_
+	//Tiles that are not set in allowed_ are treated as blocked, pass nullptr to search the whole grid
+	static bool FindPath(const FGridMap& grid_, FGridSearchContext& context_, int32 start_, int32 goal_, const FGridBitset* allowed_, TArray<int32>& outPath_);
+};
@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMap.h"
+
+//Any-angle paths by string pulling a tile path against the grid. Only the corners are kept,
+//so units walk straight lines between them instead of zig-zagging from tile to tile
+class GRIDCORE_API FGridAnyAngle
+{
+public:
+	//Waypoints of path_ (walking order, without start_) in walking order. The last tile is always kept.
+	//A straight line replaces part of the path only if every tile it touches is traversable, set in allowed_
+	//and no more expensive than the worst terrain on the tiles it replaces, so shortcuts never go through worse ground
+	static void ReducePath(const FGridMap& grid_, int32 start_, const TArray<int32>& path_, const FGridBitset* allowed_, TArray<int32>& outWaypoints_);
+
+	//Whether the straight line between the tile centers only touches tiles that can be walked on, with terrain up to maxTerrainCost_.
+	//Lines through a tile corner touch both tiles beside it, so a unit never clips the corner of an obstacle
+	static bool IsWalkable(const FGridMap& grid_, int32 from_, int32 to_, const FGridBitset* allowed_, uint8 maxTerrainCost_);
+};
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeBool.h"
+#include "GridSearchContext.h"
+
+//Search contexts are sized to the grid, so queries borrow them from a shared pool instead of allocating one each
+class GRIDCORE_API FGridSearchContextPool
+{
+public:
+	TUniquePtr<FGridSearchContext> Acquire();
+	void Release(TUniquePtr<FGridSearchContext> context_);
+
+private:
+	FCriticalSection lock;
+	TArray<TUniquePtr<FGridSearchContext>> contexts;
+};
+
+typedef TSharedRef<FGridSearchContextPool, ESPMode::ThreadSafe> FGridSearchContextPoolRef;
+
+//A search running on a background task. Work only ever sees data captured when the query was launched,
+//so it never touches the live grid
+class GRIDCORE_API FGridAsyncQuery
+{
+public:
+	FGridAsyncQuery();
+
+	//The completion callback won't run after this. A search that has already started finishes in the background
+	void Cancel();
+	bool IsCancelled() const { return bCancelled; }
+
+	//Runs work_ on a background thread with a pooled search context, then onComplete_ on the game thread unless the query got cancelled
+	static TSharedRef<FGridAsyncQuery, ESPMode::ThreadSafe> Launch(const FGridSearchContextPoolRef& pool_, TFunction<void(FGridSearchContext&)> work_, TFunction<void()> onComplete_);
+
+private:
+	FThreadSafeBool bCancelled;
+};
+
+typedef TSharedPtr<FGridAsyncQuery, ESPMode::ThreadSafe> FGridAsyncQueryPtr;
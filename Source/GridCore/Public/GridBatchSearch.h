@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMap.h"
+#include "GridAsyncQuery.h"
+
+struct FGridPathRequest
+{
+	int32 start;
+	int32 goal;
+
+	FGridPathRequest()
+		: start(INDEX_NONE), goal(INDEX_NONE)
+	{
+	}
+
+	FGridPathRequest(int32 start_, int32 goal_)
+		: start(start_), goal(goal_)
+	{
+	}
+};
+
+struct FGridPathResult
+{
+	bool bFound;
+	//Walking order without the start tile, same as the single path searches
+	TArray<int32> path;
+
+	FGridPathResult()
+		: bFound(false)
+	{
+	}
+};
+
+//Search used for each request of a batch. It gets called from several threads at once so it must not touch shared mutable state
+typedef TFunctionRef<bool(FGridSearchContext& context_, int32 start_, int32 goal_, TArray<int32>& outPath_)> FGridPathSearchRef;
+
+//Runs many independent path queries across the worker threads. Every worker borrows one search context
+//for all the requests it picks up, and requests are handed out one at a time so long and short paths balance out
+class GRIDCORE_API FGridBatchSearch
+{
+public:
+	//outResults_[i] is the answer to requests_[i]
+	static void FindPaths(FGridSearchContextPool& pool_, const TArray<FGridPathRequest>& requests_, FGridPathSearchRef search_, TArray<FGridPathResult>& outResults_);
+};
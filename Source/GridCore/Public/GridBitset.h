@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//One bit per tile, packed into 64 bit words
+class FGridBitset
+{
+public:
+	FGridBitset()
+		: numBits(0)
+	{
+	}
+
+	void Init(int32 numBits_, bool value_)
+	{
+		numBits = numBits_;
+		words.Init(value_ ? ~0ull : 0ull, FMath::DivideAndRoundUp(numBits_, 64));
+		ClearPadding();
+	}
+
+	//Copies the bits from packed words laid out like GetWords()
+	void Init(int32 numBits_, const uint64* words_)
+	{
+		numBits = numBits_;
+		words.SetNumUninitialized(FMath::DivideAndRoundUp(numBits_, 64));
+		FMemory::Memcpy(words.GetData(), words_, words.Num() * sizeof(uint64));
+		ClearPadding();
+	}
+
+	int32 Num() const
+	{
+		return numBits;
+	}
+
+	FORCEINLINE bool Get(int32 index_) const
+	{
+		checkSlow(index_ >= 0 && index_ < numBits);
+		return (words[index_ >> 6] >> (index_ & 63)) & 1ull;
+	}
+
+	FORCEINLINE void Set(int32 index_, bool value_)
+	{
+		checkSlow(index_ >= 0 && index_ < numBits);
+		const uint64 mask = 1ull << (index_ & 63);
+		if (value_)
+			words[index_ >> 6] |= mask;
+		else
+			words[index_ >> 6] &= ~mask;
+	}
+
+	void SetAll(bool value_)
+	{
+		FMemory::Memset(words.GetData(), value_ ? 0xff : 0, words.Num() * sizeof(uint64));
+		ClearPadding();
+	}
+
+	int32 CountSetBits() const
+	{
+		int32 count = 0;
+		for (int32 i = 0; i < words.Num(); i++)
+		{
+			count += FPlatformMath::CountBits(words[i]);
+		}
+		return count;
+	}
+
+	//Returns the first set bit at or after from_, or INDEX_NONE
+	int32 FindNextSetBit(int32 from_) const
+	{
+		if (from_ >= numBits)
+			return INDEX_NONE;
+
+		int32 w = from_ >> 6;
+		uint64 word = words[w] & (~0ull << (from_ & 63));
+		while (word == 0)
+		{
+			if (++w >= words.Num())
+				return INDEX_NONE;
+			word = words[w];
+		}
+		return (w << 6) + (int32)FPlatformMath::CountTrailingZeros64(word);
+	}
+
+	TArray<uint64>& GetWords()
+	{
+		return words;
+	}
+
+	const TArray<uint64>& GetWords() const
+	{
+		return words;
+	}
+
+private:
+	//Bits past numBits in the last word are always kept at 0 so whole-word operations can ignore them
+	void ClearPadding()
+	{
+		if ((numBits & 63) != 0)
+		{
+			words.Last() &= (1ull << (numBits & 63)) - 1;
+		}
+	}
+
+	TArray<uint64> words;
+	int32 numBits;
+};
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMap.h"
+
+//Splits a grid into square chunks of chunkSize tiles. The chunks on the far edges can be smaller
+class FGridChunkLayout
+{
+public:
+	FGridChunkLayout()
+		: width(0), height(0), chunkSize(1), numChunksX(0), numChunksY(0)
+	{
+	}
+
+	void Init(int32 width_, int32 height_, int32 chunkSize_)
+	{
+		width = width_;
+		height = height_;
+		chunkSize = FMath::Max(chunkSize_, 1);
+		numChunksX = FMath::DivideAndRoundUp(width_, chunkSize);
+		numChunksY = FMath::DivideAndRoundUp(height_, chunkSize);
+	}
+
+	FORCEINLINE int32 Num() const { return numChunksX * numChunksY; }
+	FORCEINLINE int32 GetChunkSize() const { return chunkSize; }
+	FORCEINLINE int32 GetNumChunksX() const { return numChunksX; }
+	FORCEINLINE int32 GetNumChunksY() const { return numChunksY; }
+
+	FORCEINLINE int32 GetChunk(int32 x_, int32 y_) const { return (y_ / chunkSize) * numChunksX + x_ / chunkSize; }
+
+	FGridRect GetRect(int32 chunk_) const
+	{
+		const int32 minX = (chunk_ % numChunksX) * chunkSize;
+		const int32 minY = (chunk_ / numChunksX) * chunkSize;
+		return FGridRect(minX, minY, FMath::Min(minX + chunkSize, width) - 1, FMath::Min(minY + chunkSize, height) - 1);
+	}
+
+private:
+	int32 width;
+	int32 height;
+	int32 chunkSize;
+	int32 numChunksX;
+	int32 numChunksY;
+};
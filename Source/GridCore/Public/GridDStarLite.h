@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMap.h"
+#include "GridIndexedHeap.h"
+
+//D* Lite: keeps the shortest path from a moving start to a fixed goal up to date as tiles change.
+//It searches backwards from the goal and keeps its costs between replans, so a change only costs
+//the work needed around the tiles that changed instead of a whole new search
+class GRIDCORE_API FGridDStarLite
+{
+public:
+	FGridDStarLite();
+
+	void Init(const FGridMap& grid_, int32 start_, int32 goal_);
+	bool IsActive() const { return goal != INDEX_NONE; }
+	int32 GetStart() const { return start; }
+	int32 GetGoal() const { return goal; }
+
+	//The unit moved, e.g. along its path. The costs stay valid so nothing is searched until the next FindPath
+	void SetStart(const FGridMap& grid_, int32 start_);
+	//Call after the tile's traversability or terrain cost changed in grid_
+	void NotifyTileChanged(const FGridMap& grid_, int32 tile_);
+
+	//Brings the costs up to date and reads the path off them. Same output as FGridAStar::FindPath
+	bool FindPath(const FGridMap& grid_, TArray<int32>& outPath_);
+
+	//Tiles expanded by the last FindPath
+	int32 GetNodesExpanded() const { return nodesExpanded; }
+
+private:
+	int32 start;
+	int32 goal;
+	int32 keyModifier; //km in the paper, grows as the start moves so old keys stay valid lower bounds
+	int32 nodesExpanded;
+	uint32 generation;
+	uint8 heuristicTerrainCost; //Cheapest terrain on the grid when the search started
+
+	//Tiles that aren't stamped with the current generation have g and rhs at infinity
+	TArray<uint32> stamps;
+	TArray<int32> gCost;
+	TArray<int32> rhsCost;
+	FGridIndexedHeap open;
+
+	FORCEINLINE bool IsTouched(int32 tile_) const { return stamps[tile_] == generation; }
+	FORCEINLINE int32 GetG(int32 tile_) const { return IsTouched(tile_) ? gCost[tile_] : MAX_int32; }
+	FORCEINLINE int32 GetRhs(int32 tile_) const { return IsTouched(tile_) ? rhsCost[tile_] : MAX_int32; }
+	void Touch(int32 tile_);
+
+	int64 CalculateKey(const FGridMap& grid_, int32 tile_) const;
+	//Recomputes the tile's rhs from its neighbors and puts it in the open list if it's inconsistent
+	void UpdateTile(const FGridMap& grid_, int32 tile_);
+	void UpdateNeighbors(const FGridMap& grid_, int32 tile_);
+	void ComputeShortestPath(const FGridMap& grid_);
+};
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMap.h"
+
+class FGridHierarchy;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+//Sections a baked grid file can hold. Unknown ids are skipped so new sections don't break older readers
+enum class EGridFileSection : uint32
+{
+	Traversable = 1, //Traversability bitset words, laid out like FGridBitset
+	Hierarchy = 2, //Serialized FGridHierarchy
+	Terrain = 3, //One terrain cost byte per tile in index order
+};
+
+//Baked grid data for instant level startup. The file is a fixed header, a section table and
+//8 byte aligned sections, so a memory mapped file can be used without parsing or copying it first.
+//Layout (little endian):
+//  header   magic "GRID", format version, width, height, number of sections, reserved
+//  table    per section: id, reserved, offset from the start of the file, size in bytes
+//  sections
+class GRIDCORE_API FGridFile
+{
+public:
+	static const uint32 Magic;
+	static const uint32 FormatVersion;
+
+	FGridFile();
+	~FGridFile();
+
+	//Writes the grid and, when given, its hierarchy. The hierarchy has to be up to date
+	static bool Save(const TCHAR* filename_, const FGridMap& grid_, const FGridHierarchy* hierarchy_);
+
+	//Memory maps the file, or reads it whole on platforms that can't map it. Fails if the header isn't valid
+	bool Open(const TCHAR* filename_);
+	void Close();
+	bool IsOpen() const { return data != nullptr; }
+
+	int32 GetWidth() const { return width; }
+	int32 GetHeight() const { return height; }
+
+	//Raw section bytes or nullptr if the file doesn't have the section. Only valid while the file is open
+	const uint8* FindSection(EGridFileSection section_, int64& outSize_) const;
+
+	//Initializes the grid from the file with a single copy of the traversability bits and terrain costs
+	//Files without terrain leave every tile at the default cost
+	bool LoadGrid(FGridMap& outGrid_) const;
+	//Fails when there's no hierarchy or it was built for another grid size or cluster size
+	bool LoadHierarchy(const FGridMap& grid_, int32 clusterSize_, FGridHierarchy& outHierarchy_) const;
+
+private:
+	TUniquePtr<IMappedFileHandle> mappedFile;
+	TUniquePtr<IMappedFileRegion> mappedRegion;
+	TArray<uint8> fileData; //Only used when the file couldn't be mapped
+	const uint8* data;
+	int64 size;
+	int32 width;
+	int32 height;
+
+	bool ReadHeader();
+};
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMap.h"
+#include "GridSearchContext.h"
+
+//Cost to a single goal from every tile of the grid, and which way to step to get closer.
+//Any number of units heading to the same goal read their next step from it in O(1)
+class GRIDCORE_API FGridFlowField
+{
+public:
+	static const uint8 NoDirection = 0xFF;
+
+	FGridFlowField();
+
+	//One Dijkstra sweep outwards from the goal. Steps cost the same both ways so it's also the cost towards the goal
+	void Build(const FGridMap& grid_, FGridSearchContext& context_, int32 goal_);
+
+	int32 GetGoal() const { return goal; }
+	//Grid version the field was built against
+	uint32 GetVersion() const { return version; }
+
+	FORCEINLINE bool IsReachable(int32 tile_) const { return costs[tile_] != MAX_int32; }
+	//Cost to the goal, MAX_int32 if the goal can't be reached from the tile
+	FORCEINLINE int32 GetCost(int32 tile_) const { return costs[tile_]; }
+	//Direction of the next step in FGridMap's direction order, NoDirection at the goal or if it can't be reached
+	FORCEINLINE uint8 GetDirection(int32 tile_) const { return directions[tile_]; }
+	//Tile to step on next, INDEX_NONE at the goal or if it can't be reached
+	int32 GetNextTile(int32 tile_) const;
+
+	//Follows the field from start_. outPath_ gets the tiles in walking order, without start_
+	bool GetPath(int32 start_, TArray<int32>& outPath_) const;
+
+private:
+	int32 goal;
+	int32 width;
+	uint32 version;
+	TArray<int32> costs;
+	TArray<uint8> directions;
+};
+
+//Keeps the fields of the most recently used goals
+class GRIDCORE_API FGridFlowFieldCache
+{
+public:
+	FGridFlowFieldCache();
+
+	void SetCapacity(int32 capacity_);
+	int32 GetCapacity() const { return capacity; }
+	int32 Num() const { return entries.Num(); }
+	void Empty();
+
+	//Returns the field towards goal_ on the grid's current version, building it on a miss.
+	//The reference stays valid until the next call to Find
+	const FGridFlowField& Find(const FGridMap& grid_, FGridSearchContext& context_, int32 goal_);
+
+private:
+	int32 capacity;
+	//Least recently used first
+	TArray<TUniquePtr<FGridFlowField>> entries;
+};
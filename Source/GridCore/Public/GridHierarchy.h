@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMap.h"
+#include "GridSearchContext.h"
+
+//HPA* abstraction of a grid map. The grid is split into square clusters, the tiles where two clusters
+//can be crossed become abstract nodes, and the cost between the nodes of a cluster is precomputed.
+//Long paths are found on the abstract graph first and only refined inside the clusters they go through
+class GRIDCORE_API FGridHierarchy
+{
+public:
+	FGridHierarchy();
+
+	void Build(const FGridMap& grid_, int32 clusterSize_);
+	bool IsBuilt() const { return clusters.Num() > 0; }
+	//True when the hierarchy was built for a grid of this size with this cluster size
+	bool IsBuiltFor(const FGridMap& grid_, int32 clusterSize_) const;
+
+	//Saves or loads the built abstraction so it doesn't have to be rebuilt at startup
+	//Only a hierarchy that's up to date can be saved. A failed load leaves it empty
+	void Serialize(FArchive& ar_);
+
+	//Flags the cluster of a tile whose traversability changed. Only flagged clusters are rebuilt by Update
+	void MarkTileChanged(const FGridMap& grid_, int32 tile_);
+	void Update(const FGridMap& grid_);
+	bool IsDirty() const { return dirtyClusters.Num() > 0; }
+
+	//Same contract as FGridAStar::FindPath, without an allowed mask. The hierarchy has to be up to date
+	//The path is near optimal: it's optimal inside each cluster but only crosses clusters at entrances
+	//The context only counts the last cluster search, outNodesExpanded_ gets every tile and abstract node expanded when it's given
+	bool FindPath(const FGridMap& grid_, FGridSearchContext& context_, int32 start_, int32 goal_, TArray<int32>& outPath_, int32* outNodesExpanded_ = nullptr) const;
+
+	int32 GetClusterSize() const { return clusterSize; }
+	int32 GetNumNodes() const { return nodes.Num() - freeNodes.Num(); }
+
+private:
+	struct FNode
+	{
+		int32 tile;
+		int32 cluster;
+		int32 partner; //Node on the other side of the entrance
+		int32 partnerCost;
+		int32 slot; //Position in the cluster's node list
+	};
+
+	struct FCluster
+	{
+		FGridRect rect;
+		TArray<int32> nodes;
+		TArray<int32> distances; //nodes.Num() x nodes.Num() intra cluster costs, MAX_int32 when unreachable
+		//Nodes of the entrances leaving this cluster's east and north edges, both sides
+		//Diagonal steps off the east edge can end in the north-east or south-east cluster
+		TArray<int32> eastBorder;
+		TArray<int32> northBorder;
+	};
+
+	int32 clusterSize;
+	int32 clustersX;
+	int32 clustersY;
+	TArray<FNode> nodes;
+	TArray<int32> freeNodes;
+	TArray<FCluster> clusters;
+	TArray<int32> dirtyClusters;
+	FGridSearchContext buildContext;
+
+	//Checks the ids and tables of a loaded hierarchy against each other, so a corrupt file can't index out of range
+	bool IsConsistent() const;
+	int32 GetCluster(const FGridMap& grid_, int32 tile_) const;
+	//Clusters whose node lists change are added to changed_ when it's given
+	int32 AddNode(int32 tile_, int32 cluster_, TArray<int32>* changed_);
+	void RemoveNode(int32 node_, TArray<int32>* changed_);
+	void BuildBorder(const FGridMap& grid_, int32 cluster_, bool bNorth_, TArray<int32>* changed_);
+	void BuildDistances(const FGridMap& grid_, int32 cluster_);
+
+	//Dijkstra (or A* when target_ is given) that never leaves rect_
+	static bool SearchInRect(const FGridMap& grid_, FGridSearchContext& context_, int32 source_, int32 target_, const FGridRect& rect_);
+};
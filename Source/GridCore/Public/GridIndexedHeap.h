@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//Binary min heap of tile indices. Every tile remembers where it sits in the heap,
+//so membership is O(1) and a tile's key can be changed in place (decrease-key)
+class GRIDCORE_API FGridIndexedHeap
+{
+public:
+	FGridIndexedHeap();
+
+	void Init(int32 numItems_);
+	//Empties the heap. Only touches the items that are still in it
+	void Reset();
+
+	FORCEINLINE int32 Num() const { return heap.Num(); }
+	FORCEINLINE bool IsEmpty() const { return heap.Num() == 0; }
+	FORCEINLINE int32 GetCapacity() const { return positions.Num(); }
+	//Most items the heap held at once since it was last initialized or reset
+	FORCEINLINE int32 GetPeak() const { return peak; }
+	FORCEINLINE bool Contains(int32 item_) const { return positions[item_] != INDEX_NONE; }
+	FORCEINLINE int32 Top() const { return heap[0].item; }
+	FORCEINLINE int64 TopKey() const { return heap[0].key; }
+	FORCEINLINE int64 GetKey(int32 item_) const { return heap[positions[item_]].key; }
+
+	void Push(int32 item_, int64 key_);
+	//Pushes the item or moves it to its new key if it's already in the heap
+	void Update(int32 item_, int64 key_);
+	int32 Pop();
+	void Remove(int32 item_);
+
+private:
+	struct FNode
+	{
+		int64 key;
+		int32 item;
+	};
+
+	TArray<FNode> heap;
+	TArray<int32> positions; //Heap slot of each item, INDEX_NONE when it's not in the heap
+	int32 peak;
+
+	void SiftUp(int32 slot_);
+	void SiftDown(int32 slot_);
+	FORCEINLINE void Place(int32 slot_, const FNode& node_)
+	{
+		heap[slot_] = node_;
+		positions[node_.item] = slot_;
+	}
+};
@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMap.h"
+#include "GridSearchContext.h"
+
+//Jump Point Search. Only valid while every straight step costs the same and every diagonal step costs the same,
+//in exchange it only puts jump points on the open list instead of every tile it looks at.
+//Grids with mixed terrain costs are searched with A* instead
+//Diagonal moves are allowed past blocked corners, same as the A* search, so both return paths of the same cost
+class GRIDCORE_API FGridJumpPointSearch
+{
+public:
+	//Same contract as FGridAStar::FindPath. The jump points are expanded so outPath_ still has every tile on the way
+	static bool FindPath(const FGridMap& grid_, FGridSearchContext& context_, int32 start_, int32 goal_, const FGridBitset* allowed_, TArray<int32>& outPath_);
+};
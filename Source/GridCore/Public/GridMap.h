@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBitset.h"
+
+//Cost of moving to an immediate or a diagonal neighbor over default terrain
+namespace GridCost
+{
+	static const int32 Straight = 10;
+	static const int32 Diagonal = 14;
+	//Terrain costs are in tenths of the default, e.g. 7 for a road or 20 for mud. 0 isn't a valid cost
+	static const uint8 DefaultTerrain = 10;
+}
+
+//Inclusive tile rectangle
+struct FGridRect
+{
+	int32 minX;
+	int32 minY;
+	int32 maxX;
+	int32 maxY;
+
+	FGridRect()
+		: minX(0), minY(0), maxX(-1), maxY(-1)
+	{
+	}
+
+	FGridRect(int32 minX_, int32 minY_, int32 maxX_, int32 maxY_)
+		: minX(minX_), minY(minY_), maxX(maxX_), maxY(maxY_)
+	{
+	}
+
+	FORCEINLINE bool Contains(int32 x_, int32 y_) const { return x_ >= minX && x_ <= maxX && y_ >= minY && y_ <= maxY; }
+	FORCEINLINE int32 GetWidth() const { return maxX - minX + 1; }
+	FORCEINLINE int32 GetHeight() const { return maxY - minY + 1; }
+};
+
+//Engine independent grid storage. Tiles are addressed by a single index (y * width + x)
+//and all per-tile state lives in dense arrays instead of on individual actors
+class GRIDCORE_API FGridMap
+{
+public:
+	FGridMap();
+
+	//Neighbors are implicit offsets. The first 4 directions are immediate neighbors, the last 4 are diagonal
+	static const int32 NumDirections = 8;
+	static const int32 NumStraightDirections = 4;
+	static const int32 DirectionX[NumDirections];
+	static const int32 DirectionY[NumDirections];
+
+	void Init(int32 width_, int32 height_);
+	//Takes the traversability from packed bitset words, e.g. straight out of a baked grid file
+	void Init(int32 width_, int32 height_, const uint64* traversableWords_);
+
+	FORCEINLINE int32 GetWidth() const { return width; }
+	FORCEINLINE int32 GetHeight() const { return height; }
+	FORCEINLINE int32 Num() const { return width * height; }
+
+	FORCEINLINE bool IsValid(int32 x_, int32 y_) const { return x_ >= 0 && y_ >= 0 && x_ < width && y_ < height; }
+	FORCEINLINE bool IsValidIndex(int32 index_) const { return index_ >= 0 && index_ < Num(); }
+	FORCEINLINE int32 ToIndex(int32 x_, int32 y_) const { return y_ * width + x_; }
+	FORCEINLINE int32 GetX(int32 index_) const { return index_ % width; }
+	FORCEINLINE int32 GetY(int32 index_) const { return index_ / width; }
+
+	//Returns the neighbor of the tile in the given direction or INDEX_NONE if it's off the grid
+	int32 GetNeighbor(int32 index_, int32 direction_) const;
+	static FORCEINLINE bool IsDiagonal(int32 direction_) { return direction_ >= NumStraightDirections; }
+	//Cost of a step between neighbors, using the average terrain cost of both tiles so it's the same both ways
+	//and searches that run from the goal, like flow fields, D* Lite or the hierarchy's distances, stay exact
+	FORCEINLINE int32 GetStepCost(int32 from_, int32 to_, bool bDiagonal_) const
+	{
+		const int32 terrain = (int32)terrainCosts[from_] + (int32)terrainCosts[to_];
+		return (bDiagonal_ ? GridCost::Diagonal : GridCost::Straight) * terrain / (2 * GridCost::DefaultTerrain);
+	}
+
+	FORCEINLINE bool IsTraversable(int32 index_) const { return traversable.Get(index_); }
+	void SetTraversable(int32 index_, bool value_);
+	const FGridBitset& GetTraversableMask() const { return traversable; }
+
+	//One byte per tile in index order, so searches read it alongside the traversability bits
+	FORCEINLINE uint8 GetTerrainCost(int32 index_) const { return terrainCosts[index_]; }
+	void SetTerrainCost(int32 index_, uint8 cost_);
+	//Replaces every tile's cost at once, Num() bytes in index order
+	void SetTerrainCosts(const uint8* costs_);
+	const TArray<uint8>& GetTerrainCosts() const { return terrainCosts; }
+	FORCEINLINE uint8 GetMinTerrainCost() const { return minTerrainCost; }
+	//True while every tile costs the same, which searches that assume uniform costs need
+	FORCEINLINE bool HasUniformTerrain() const { return terrainCounts[minTerrainCost] == Num(); }
+
+	//Bumped every time traversability or terrain changes, so anything computed from the grid can tell it's out of date
+	FORCEINLINE uint32 GetVersion() const { return version; }
+
+	//Octile distance between two tiles over the cheapest terrain on the grid.
+	//Never overestimates the real cost so it's safe to use as a heuristic
+	int32 GetDistanceEstimate(int32 from_, int32 to_) const;
+
+private:
+	int32 width;
+	int32 height;
+	FGridBitset traversable;
+	TArray<uint8> terrainCosts;
+	//Tiles per terrain cost, so the cheapest cost is known exactly without scanning the grid
+	int32 terrainCounts[256];
+	uint8 minTerrainCost;
+	uint32 version;
+
+	void ResetTerrain();
+	void UpdateMinTerrainCost();
+};
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMap.h"
+#include "GridSearchContext.h"
+
+//Every tile reachable from an origin within a movement budget, with the cheapest way to get there.
+//Storage is proportional to the number of reachable tiles, not to the size of the grid
+class GRIDCORE_API FGridReachability
+{
+public:
+	FGridReachability();
+
+	//Bounded Dijkstra from origin_. Tiles costing more than budget_ to reach are left out
+	void Compute(const FGridMap& grid_, FGridSearchContext& context_, int32 origin_, int32 budget_);
+	void Reset();
+
+	int32 GetOrigin() const { return origin; }
+	int32 GetBudget() const { return budget; }
+	//Grid version the range was computed against
+	uint32 GetVersion() const { return version; }
+	bool IsValid() const { return origin != INDEX_NONE; }
+
+	//Reachable tiles, cheapest first. The origin is always the first one
+	const TArray<int32>& GetTiles() const { return tiles; }
+	int32 Num() const { return tiles.Num(); }
+
+	bool Contains(int32 tile_) const { return slots.Contains(tile_); }
+	//Cost to reach the tile, MAX_int32 if it's not reachable
+	int32 GetCost(int32 tile_) const;
+
+	//Walks the parent tree from goal_ back to the origin. outPath_ gets the tiles in walking order, without the origin
+	bool GetPath(int32 goal_, TArray<int32>& outPath_) const;
+
+private:
+	int32 origin;
+	int32 budget;
+	uint32 version;
+	TArray<int32> tiles;
+	TArray<int32> costs;
+	TArray<int32> parents; //Slot of the parent tile in tiles, INDEX_NONE for the origin
+	TMap<int32, int32> slots; //Tile to its slot in tiles
+};
+
+//Keeps the most recently used ranges around so selecting the same tile again on an unchanged grid is free
+class GRIDCORE_API FGridReachabilityCache
+{
+public:
+	FGridReachabilityCache();
+
+	//Older entries are dropped once there are more than capacity_
+	void SetCapacity(int32 capacity_);
+	int32 GetCapacity() const { return capacity; }
+	int32 Num() const { return entries.Num(); }
+	void Empty();
+
+	//Returns the range for (origin_, budget_) on the grid's current version, computing it on a miss.
+	//The reference stays valid until the next call to Find or Add
+	const FGridReachability& Find(const FGridMap& grid_, FGridSearchContext& context_, int32 origin_, int32 budget_);
+	//Same lookup without computing anything on a miss
+	const FGridReachability* FindCached(uint32 version_, int32 origin_, int32 budget_);
+	//Stores a range that was computed elsewhere, e.g. by an async query
+	const FGridReachability& Add(FGridReachability&& range_);
+
+	int32 GetHits() const { return hits; }
+	int32 GetMisses() const { return misses; }
+
+private:
+	int32 capacity;
+	int32 hits;
+	int32 misses;
+	//Least recently used first. Entries are allocated once and recycled so their arrays keep their capacity
+	TArray<TUniquePtr<FGridReachability>> entries;
+
+	int32 FindEntry(uint32 version_, int32 origin_, int32 budget_) const;
+	//Hands out an entry to overwrite, recycling an old one when possible
+	TUniquePtr<FGridReachability> TakeEntry(uint32 version_);
+};
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridIndexedHeap.h"
+
+//Per-query search scratch keyed by tile index. Each search bumps a generation counter instead of
+//clearing the arrays, so starting a new search is O(1). Separate contexts can search the same grid at once
+class GRIDCORE_API FGridSearchContext
+{
+public:
+	FGridSearchContext();
+
+	//Starts a new search over a grid of numTiles_ tiles, everything from the previous one becomes stale
+	void Begin(int32 numTiles_);
+
+	FORCEINLINE bool IsVisited(int32 tile_) const { return stamps[tile_] >= generation; }
+	FORCEINLINE bool IsClosed(int32 tile_) const { return stamps[tile_] == generation + 1; }
+	FORCEINLINE int32 GetGCost(int32 tile_) const { return IsVisited(tile_) ? gCost[tile_] : MAX_int32; }
+	FORCEINLINE int32 GetParent(int32 tile_) const { return IsVisited(tile_) ? parentTile[tile_] : INDEX_NONE; }
+
+	//Records a (better) cost for the tile. Reopens it if it was closed
+	FORCEINLINE void Visit(int32 tile_, int32 gCost_, int32 parent_)
+	{
+		stamps[tile_] = generation;
+		gCost[tile_] = gCost_;
+		parentTile[tile_] = parent_;
+	}
+
+	FORCEINLINE void Close(int32 tile_)
+	{
+		stamps[tile_] = generation + 1;
+		nodesExpanded++;
+	}
+
+	FGridIndexedHeap& GetOpenList() { return open; }
+
+	//Walks the parents back from goal_ and writes the tiles in walking order, without start_
+	void BuildPath(int32 start_, int32 goal_, TArray<int32>& outPath_) const;
+
+	int32 GetNodesExpanded() const { return nodesExpanded; }
+	//Adds the search so far to the grid stats, see GridStats.h
+	void ReportStats() const;
+
+#if WITH_DEV_AUTOMATION_TESTS
+	//Lets tests reach the generation wrap without running billions of searches
+	uint32 GetGenerationForTesting() const { return generation; }
+	void SetGenerationForTesting(uint32 generation_) { generation = generation_; }
+#endif
+
+private:
+	TArray<uint32> stamps; //generation: visited, generation + 1: closed, anything lower: stale
+	TArray<int32> gCost;
+	TArray<int32> parentTile;
+	FGridIndexedHeap open;
+	uint32 generation;
+	int32 nodesExpanded;
+};
@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+//Everything the grid spends time on, shown with "stat Grid". Searches on worker threads are counted too.
+//The cycle counters also show up as named events in external profilers with "stat namedevents"
+DECLARE_STATS_GROUP(TEXT("Grid"), STATGROUP_Grid, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("A* search"), STAT_GridAStar, STATGROUP_Grid, GRIDCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Jump point search"), STAT_GridJumpPoint, STATGROUP_Grid, GRIDCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hierarchy path"), STAT_GridHierarchyPath, STATGROUP_Grid, GRIDCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hierarchy build"), STAT_GridHierarchyBuild, STATGROUP_Grid, GRIDCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hierarchy update"), STAT_GridHierarchyUpdate, STATGROUP_Grid, GRIDCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("D* Lite repair"), STAT_GridDStarLite, STATGROUP_Grid, GRIDCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Movement range"), STAT_GridRange, STATGROUP_Grid, GRIDCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Step range"), STAT_GridStepRange, STATGROUP_Grid, GRIDCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Flow field build"), STAT_GridFlowField, STATGROUP_Grid, GRIDCORE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Visibility"), STAT_GridVisibility, STATGROUP_Grid, GRIDCORE_API);
+
+//Tiles closed by every search this frame
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Nodes expanded"), STAT_GridNodesExpanded, STATGROUP_Grid, GRIDCORE_API);
+//Largest open list of the last search
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Open list peak"), STAT_GridOpenListPeak, STATGROUP_Grid, GRIDCORE_API);
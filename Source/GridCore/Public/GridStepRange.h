@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMap.h"
+
+//Every tile reachable from an origin in at most a number of steps, diagonals included, ignoring step and terrain costs.
+//Only the window the steps can reach is copied into rows of 64 bit words, and the reached tiles grow one step at a time
+//with shifts, ANDs and ORs over whole words. The word loops are kept simple enough for the compiler to vectorize
+class GRIDCORE_API FGridStepRange
+{
+public:
+	FGridStepRange();
+
+	void Compute(const FGridMap& grid_, int32 origin_, int32 maxSteps_);
+	void Reset();
+
+	int32 GetOrigin() const { return origin; }
+	int32 GetMaxSteps() const { return maxSteps; }
+	//Grid version the range was computed against
+	uint32 GetVersion() const { return version; }
+	bool IsValid() const { return origin != INDEX_NONE; }
+
+	//Reachable tiles in grid index order, origin included. Ready to use as a highlight or search mask
+	const FGridBitset& GetMask() const { return mask; }
+	bool Contains(int32 tile_) const { return tile_ >= 0 && tile_ < mask.Num() && mask.Get(tile_); }
+
+private:
+	int32 origin;
+	int32 maxSteps;
+	uint32 version;
+	FGridBitset mask;
+
+	//Scratch rows of the window, kept between calls so computing a range doesn't allocate
+	TArray<uint64> open;
+	TArray<uint64> reached;
+	TArray<uint64> dilated;
+};
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridMap.h"
+
+struct FGridSightQuery
+{
+	int32 from;
+	int32 to;
+
+	FGridSightQuery()
+		: from(INDEX_NONE), to(INDEX_NONE)
+	{
+	}
+
+	FGridSightQuery(int32 from_, int32 to_)
+		: from(from_), to(to_)
+	{
+	}
+};
+
+//Line of sight on the grid itself, without physics. Tiles that aren't traversable block sight and everything else is see-through.
+//Blocking tiles can be seen themselves, so a unit can target the wall or obstacle in front of it
+class GRIDCORE_API FGridVisibility
+{
+public:
+	FGridVisibility();
+
+	//Every tile visible from origin_ within radius_ tiles (euclidean), by recursive shadowcasting over the 8 octants
+	void Compute(const FGridMap& grid_, int32 origin_, int32 radius_);
+	void Reset();
+
+	int32 GetOrigin() const { return origin; }
+	int32 GetRadius() const { return radius; }
+	//Grid version the visibility was computed against
+	uint32 GetVersion() const { return version; }
+	bool IsValid() const { return origin != INDEX_NONE; }
+
+	//Visible tiles in grid index order, origin included
+	const FGridBitset& GetMask() const { return mask; }
+	bool Contains(int32 tile_) const { return tile_ >= 0 && tile_ < mask.Num() && mask.Get(tile_); }
+
+	//Bresenham line between the two tiles with nothing blocking in between. It's checked from both ends so it's symmetric
+	static bool HasLineOfSight(const FGridMap& grid_, int32 from_, int32 to_);
+
+	//Batches for AI turns, spread over the worker threads. Results are in the same order as the input
+	static void HasLineOfSight(const FGridMap& grid_, const TArray<FGridSightQuery>& queries_, TArray<bool>& outVisible_);
+	static void Compute(const FGridMap& grid_, const TArray<int32>& origins_, int32 radius_, TArray<FGridVisibility>& outResults_);
+
+private:
+	int32 origin;
+	int32 radius;
+	uint32 version;
+	FGridBitset mask;
+
+	//One octant of the shadowcast, rows from row_ outwards between the start_ and end_ slopes.
+	//The multipliers turn octant coordinates into grid offsets
+	void CastLight(const FGridMap& grid_, int32 row_, float start_, float end_, int32 xx_, int32 xy_, int32 yx_, int32 yy_);
+	static bool TraceLine(const FGridMap& grid_, int32 from_, int32 to_);
+};
@@ -0,0 +1,409 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridBenchmarkCommandlet.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "GridAStar.h"
+#include "GridJumpPointSearch.h"
+#include "GridAnyAngle.h"
+#include "GridHierarchy.h"
+#include "GridReachability.h"
+#include "GridStepRange.h"
+#include "GridBatchSearch.h"
+#include "GridTut.h"
+
+namespace
+{
+	//Upper bound on the runs of one case, so tiny boards don't spin for the whole min time
+	const int64 MaxOps = 1000000;
+	const int32 NumPathPairs = 64;
+	const int32 RangeSteps = 8;
+	const int32 BenchmarkClusterSize = 16;
+
+	//Forwards to the real allocator and counts what goes through it while a case runs. Installed once and never
+	//removed, so a thread that picked it up from GMalloc can always still call it
+	class FGridCountingMalloc : public FMalloc
+	{
+	public:
+		explicit FGridCountingMalloc(FMalloc* inner_)
+			: inner(inner_), bCounting(0), countedThread(0), allocations(0), bytes(0)
+		{
+		}
+
+		//Counts only the allocations of thread_, or of every thread when it's 0
+		void Start(uint32 thread_)
+		{
+			allocations = 0;
+			bytes = 0;
+			countedThread = thread_;
+			FPlatformAtomics::InterlockedExchange(&bCounting, 1);
+		}
+
+		void Stop()
+		{
+			FPlatformAtomics::InterlockedExchange(&bCounting, 0);
+		}
+
+		virtual void* Malloc(SIZE_T count_, uint32 alignment_) override
+		{
+			Count(count_);
+			return inner->Malloc(count_, alignment_);
+		}
+
+		virtual void* Realloc(void* original_, SIZE_T count_, uint32 alignment_) override
+		{
+			if (count_ > 0)
+			{
+				Count(count_);
+			}
+			return inner->Realloc(original_, count_, alignment_);
+		}
+
+		virtual void Free(void* original_) override
+		{
+			inner->Free(original_);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T count_, uint32 alignment_) override
+		{
+			return inner->QuantizeSize(count_, alignment_);
+		}
+
+		virtual bool GetAllocationSize(void* original_, SIZE_T& outSize_) override
+		{
+			return inner->GetAllocationSize(original_, outSize_);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return inner->IsInternallyThreadSafe();
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return inner->ValidateHeap();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return inner->GetDescriptiveName();
+		}
+
+		int64 GetAllocations() const { return allocations; }
+		int64 GetBytes() const { return bytes; }
+
+	private:
+		FMalloc* inner;
+		volatile int32 bCounting;
+		volatile uint32 countedThread;
+		volatile int64 allocations;
+		volatile int64 bytes;
+
+		FORCEINLINE void Count(SIZE_T count_)
+		{
+			if (bCounting && (countedThread == 0 || countedThread == FPlatformTLS::GetCurrentThreadId()))
+			{
+				FPlatformAtomics::InterlockedIncrement(&allocations);
+				FPlatformAtomics::InterlockedAdd(&bytes, (int64)count_);
+			}
+		}
+	};
+
+	FGridCountingMalloc* GetCountingMalloc()
+	{
+		//Leaked on purpose, see above
+		static FGridCountingMalloc* counter = nullptr;
+		if (!counter)
+		{
+			counter = new FGridCountingMalloc(GMalloc);
+			GMalloc = counter;
+		}
+		return counter;
+	}
+
+	struct FBenchmarkResult
+	{
+		FString name;
+		int32 size;
+		int32 density;
+		int64 ops;
+		double nsPerOp;
+		double nodesPerOp;
+		double allocationsPerOp;
+		double bytesPerOp;
+		//Allocations were counted on every thread, not just the one running the case
+		bool bAllThreads;
+	};
+
+	//Square synthetic board with density_ percent of the tiles blocked, always the same for the same size and density
+	struct FBenchmarkBoard
+	{
+		FGridMap grid;
+		TArray<int32> blocked;
+		int32 center;
+		TArray<FGridPathRequest> pairs;
+
+		void Init(int32 size_, int32 density_)
+		{
+			FRandomStream random(size_ * 1000 + density_);
+			grid.Init(size_, size_);
+			center = grid.ToIndex(size_ / 2, size_ / 2);
+			blocked.Reset();
+			for (int32 i = 0; i < grid.Num(); i++)
+			{
+				if (i != center && random.FRandRange(0.0f, 100.0f) < density_)
+				{
+					blocked.Add(i);
+				}
+			}
+			Rasterize();
+
+			//Pairs can be unreachable from each other, failed searches are part of the cost too
+			pairs.Reset();
+			for (int32 attempt = 0; pairs.Num() < NumPathPairs && attempt < NumPathPairs * 100; attempt++)
+			{
+				const int32 start = random.RandHelper(grid.Num());
+				const int32 goal = random.RandHelper(grid.Num());
+				if (start != goal && grid.IsTraversable(start) && grid.IsTraversable(goal))
+				{
+					pairs.Add(FGridPathRequest(start, goal));
+				}
+			}
+		}
+
+		//What AGridManager::BeginPlay does to the grid, without the visuals
+		void Rasterize()
+		{
+			grid.Init(grid.GetWidth(), grid.GetHeight());
+			for (int32 i = 0; i < blocked.Num(); i++)
+			{
+				grid.SetTraversable(blocked[i], false);
+			}
+		}
+	};
+
+	//Cases that spread their work over worker threads count the allocations of every thread (bAllThreads_),
+	//which includes whatever else the engine allocated meanwhile
+	FBenchmarkResult RunCase(const TCHAR* name_, int32 size_, int32 density_, double minTime_, TFunctionRef<int64()> op_, bool bAllThreads_ = false)
+	{
+		//The first run sizes scratch buffers, steady state is what matters
+		op_();
+
+		FGridCountingMalloc* counter = GetCountingMalloc();
+		counter->Start(bAllThreads_ ? 0 : FPlatformTLS::GetCurrentThreadId());
+		int64 ops = 0;
+		int64 nodes = 0;
+		const double start = FPlatformTime::Seconds();
+		double elapsed = 0.0;
+		do
+		{
+			nodes += op_();
+			ops++;
+			elapsed = FPlatformTime::Seconds() - start;
+		} while (elapsed < minTime_ && ops < MaxOps);
+		counter->Stop();
+
+		FBenchmarkResult result;
+		result.name = name_;
+		result.size = size_;
+		result.density = density_;
+		result.ops = ops;
+		result.nsPerOp = elapsed * 1.0e9 / ops;
+		result.nodesPerOp = (double)nodes / ops;
+		result.allocationsPerOp = (double)counter->GetAllocations() / ops;
+		result.bytesPerOp = (double)counter->GetBytes() / ops;
+		result.bAllThreads = bAllThreads_;
+		UE_LOG(LogGridTut, Display, TEXT("%-16s %5dx%-5d %3d%% %14.1f ns/op %12.1f nodes/op %8.2f allocs/op%s"),
+			name_, size_, size_, density_, result.nsPerOp, result.nodesPerOp, result.allocationsPerOp, bAllThreads_ ? TEXT(" (all threads)") : TEXT(""));
+		return result;
+	}
+
+	void ParseList(const FString& params_, const TCHAR* key_, TArray<int32>& inOutValues_)
+	{
+		FString list;
+		if (!FParse::Value(*params_, key_, list, false))
+			return;
+
+		TArray<FString> entries;
+		list.ParseIntoArray(entries, TEXT(","));
+		inOutValues_.Reset();
+		for (const FString& entry : entries)
+		{
+			inOutValues_.Add(FCString::Atoi(*entry));
+		}
+	}
+
+	bool WriteResults(const FString& path_, const TArray<FBenchmarkResult>& results_)
+	{
+		FString json = TEXT("{\n\t\"cases\": [\n");
+		FString csv = TEXT("name,size,density,ops,nsPerOp,nodesPerOp,allocationsPerOp,bytesPerOp,allThreads\n");
+		for (int32 i = 0; i < results_.Num(); i++)
+		{
+			const FBenchmarkResult& result = results_[i];
+			json += FString::Printf(TEXT("\t\t{ \"name\": \"%s\", \"size\": %d, \"density\": %d, \"ops\": %lld, \"nsPerOp\": %.1f, \"nodesPerOp\": %.1f, \"allocationsPerOp\": %.2f, \"bytesPerOp\": %.1f, \"allThreads\": %s }%s\n"),
+				*result.name, result.size, result.density, result.ops, result.nsPerOp, result.nodesPerOp, result.allocationsPerOp, result.bytesPerOp,
+				result.bAllThreads ? TEXT("true") : TEXT("false"), i + 1 < results_.Num() ? TEXT(",") : TEXT(""));
+			csv += FString::Printf(TEXT("%s,%d,%d,%lld,%.1f,%.1f,%.2f,%.1f,%d\n"),
+				*result.name, result.size, result.density, result.ops, result.nsPerOp, result.nodesPerOp, result.allocationsPerOp, result.bytesPerOp, result.bAllThreads ? 1 : 0);
+		}
+		json += TEXT("\t]\n}\n");
+
+		return FFileHelper::SaveStringToFile(json, *(path_ + TEXT(".json"))) && FFileHelper::SaveStringToFile(csv, *(path_ + TEXT(".csv")));
+	}
+}
+
+UGridBenchmarkCommandlet::UGridBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UGridBenchmarkCommandlet::Main(const FString& params_)
+{
+	TArray<int32> sizes = { 5, 16, 64, 256, 1024 };
+	TArray<int32> densities = { 0, 10, 25, 40 };
+	ParseList(params_, TEXT("sizes="), sizes);
+	ParseList(params_, TEXT("densities="), densities);
+	float minTime = 0.2f;
+	FParse::Value(*params_, TEXT("mintime="), minTime);
+	FString out = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"), TEXT("GridBenchmark"));
+	FParse::Value(*params_, TEXT("out="), out);
+
+	TArray<FBenchmarkResult> results;
+	FGridSearchContext context;
+	FGridSearchContextPool pool;
+	FGridReachability range;
+	FGridStepRange stepRange;
+	FGridHierarchy hierarchy;
+	TArray<int32> path;
+	TArray<TArray<int32>> pairPaths;
+	TArray<int32> waypoints;
+	TArray<FGridPathResult> batchResults;
+	FGridBitset highlighted;
+	TArray<int32> highlightedTiles;
+	for (int32 size : sizes)
+	{
+		for (int32 density : densities)
+		{
+			if (size <= 0)
+				continue;
+
+			FBenchmarkBoard board;
+			board.Init(size, FMath::Clamp(density, 0, 100));
+			const FGridMap& grid = board.grid;
+			int32 nextPair = 0;
+			auto NextPair = [&]() -> const FGridPathRequest&
+			{
+				const FGridPathRequest& pair = board.pairs[nextPair];
+				nextPair = (nextPair + 1) % board.pairs.Num();
+				return pair;
+			};
+
+			results.Add(RunCase(TEXT("Build"), size, density, minTime, [&]()
+			{
+				board.Rasterize();
+				return (int64)0;
+			}));
+			results.Add(RunCase(TEXT("HierarchyBuild"), size, density, minTime, [&]()
+			{
+				hierarchy.Build(grid, BenchmarkClusterSize);
+				return (int64)0;
+			}));
+			results.Add(RunCase(TEXT("Range"), size, density, minTime, [&]()
+			{
+				range.Compute(grid, context, board.center, RangeSteps * GridCost::Straight);
+				return (int64)context.GetNodesExpanded();
+			}));
+			results.Add(RunCase(TEXT("StepRange"), size, density, minTime, [&]()
+			{
+				stepRange.Compute(grid, board.center, RangeSteps);
+				return (int64)0;
+			}));
+
+			//Same bookkeeping as AGridManager::HighlightTile and ClearHighlighted, without the tile visuals
+			highlighted.Init(grid.Num(), false);
+			range.Compute(grid, context, board.center, RangeSteps * GridCost::Straight);
+			results.Add(RunCase(TEXT("HighlightClear"), size, density, minTime, [&]()
+			{
+				const TArray<int32>& tiles = range.GetTiles();
+				for (int32 i = 0; i < tiles.Num(); i++)
+				{
+					if (grid.IsTraversable(tiles[i]) && !highlighted.Get(tiles[i]))
+					{
+						highlighted.Set(tiles[i], true);
+						highlightedTiles.Push(tiles[i]);
+					}
+				}
+				for (int32 i = 0; i < highlightedTiles.Num(); i++)
+				{
+					highlighted.Set(highlightedTiles[i], false);
+				}
+				highlightedTiles.Reset();
+				return (int64)tiles.Num();
+			}));
+
+			if (board.pairs.Num() == 0)
+				continue;
+
+			results.Add(RunCase(TEXT("AStar"), size, density, minTime, [&]()
+			{
+				const FGridPathRequest& pair = NextPair();
+				FGridAStar::FindPath(grid, context, pair.start, pair.goal, nullptr, path);
+				return (int64)context.GetNodesExpanded();
+			}));
+			results.Add(RunCase(TEXT("JumpPoint"), size, density, minTime, [&]()
+			{
+				const FGridPathRequest& pair = NextPair();
+				FGridJumpPointSearch::FindPath(grid, context, pair.start, pair.goal, nullptr, path);
+				return (int64)context.GetNodesExpanded();
+			}));
+			//Only the string pulling, on paths found up front. Counts path tiles instead of nodes
+			pairPaths.SetNum(board.pairs.Num());
+			for (int32 i = 0; i < board.pairs.Num(); i++)
+			{
+				FGridAStar::FindPath(grid, context, board.pairs[i].start, board.pairs[i].goal, nullptr, pairPaths[i]);
+			}
+			results.Add(RunCase(TEXT("AnyAngle"), size, density, minTime, [&]()
+			{
+				const int32 pair = nextPair;
+				NextPair();
+				FGridAnyAngle::ReducePath(grid, board.pairs[pair].start, pairPaths[pair], nullptr, waypoints);
+				return (int64)pairPaths[pair].Num();
+			}));
+			hierarchy.Build(grid, BenchmarkClusterSize);
+			results.Add(RunCase(TEXT("HierarchyPath"), size, density, minTime, [&]()
+			{
+				const FGridPathRequest& pair = NextPair();
+				int32 nodesExpanded = 0;
+				hierarchy.FindPath(grid, context, pair.start, pair.goal, path, &nodesExpanded);
+				return (int64)nodesExpanded;
+			}));
+			results.Add(RunCase(TEXT("Batch"), size, density, minTime, [&]()
+			{
+				FThreadSafeCounter nodes;
+				FGridBatchSearch::FindPaths(pool, board.pairs, [&](FGridSearchContext& context_, int32 start_, int32 goal_, TArray<int32>& outPath_)
+				{
+					const bool bFound = FGridAStar::FindPath(grid, context_, start_, goal_, nullptr, outPath_);
+					nodes.Add(context_.GetNodesExpanded());
+					return bFound;
+				}, batchResults);
+				return (int64)nodes.GetValue();
+			}, true));
+		}
+	}
+
+	if (!WriteResults(out, results))
+	{
+		UE_LOG(LogGridTut, Error, TEXT("Couldn't write the benchmark results to %s"), *out);
+		return 1;
+	}
+	UE_LOG(LogGridTut, Display, TEXT("Wrote %d benchmark cases to %s.json and %s.csv"), results.Num(), *out, *out);
+	return 0;
+}
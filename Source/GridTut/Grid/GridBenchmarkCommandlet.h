@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GridBenchmarkCommandlet.generated.h"
+
+//Headless benchmarks of the grid code on synthetic boards, no map or rendering needed:
+//  UE4Editor-Cmd GridTut.uproject -run=GridBenchmark [-sizes=5,64,1024] [-densities=0,10,25,40] [-mintime=0.2] [-out=<path without extension>]
+//Writes <out>.json and <out>.csv with ns/op, nodes expanded per op and allocations per op for every case,
+//so two builds can be compared with a plain diff. Defaults to Saved/Benchmarks/GridBenchmark
+UCLASS()
+class GRIDTUT_API UGridBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGridBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& params_) override;
+};
@@ -3,22 +3,61 @@
 
 #include "GridManager.h"
 #include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "GridStats.h"
+#include "GridTut.h"
+#include "Obstacle.h"
+#include "TerrainArea.h"
+
+DECLARE_CYCLE_STAT(TEXT("Grid build"), STAT_GridManagerBuild, STATGROUP_Grid);
+DECLARE_CYCLE_STAT(TEXT("Update current tile"), STAT_GridUpdateCurrentTile, STATGROUP_Grid);
+DECLARE_CYCLE_STAT(TEXT("Highlight tiles"), STAT_GridHighlightTiles, STATGROUP_Grid);
+DECLARE_CYCLE_STAT(TEXT("Clear highlighted"), STAT_GridClearHighlighted, STATGROUP_Grid);
+DECLARE_CYCLE_STAT(TEXT("Find path"), STAT_GridFindPath, STATGROUP_Grid);
+DECLARE_CYCLE_STAT(TEXT("Tile streaming"), STAT_GridStreaming, STATGROUP_Grid);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Tiles highlighted"), STAT_GridTilesHighlighted, STATGROUP_Grid);
+//Tiles in the last path found on the game thread
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Path length"), STAT_GridPathLength, STATGROUP_Grid);
 
 // Sets default values
 AGridManager::AGridManager()
 {
-	PrimaryActorTick.bCanEverTick = false;
+	//Only ticks to stream chunks
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 	root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 	RootComponent = root;
-	rowsNum = 5;
-	columnsNum = 5;
+	width = 5;
+	height = 5;
 	tileSize = 100.0f;
 
-	rowTiles.Reserve(rowsNum);
-	columnTiles.Reserve(columnsNum);
-	tileIndexInColumn = 0;
-	tileIndexInRows = 0;
-	columnOffset = 0;
+	bInstancedTiles = true;
+	bStreamTiles = false;
+	chunkSize = 32;
+	streamingRadius = 4000.0f;
+	tilesPerTick = 1024;
+	streamingChunk = INDEX_NONE;
+	streamedTiles = 0;
+	bStreamingIn = false;
+	pathMode = EGridPathMode::AStar;
+	bAnyAnglePaths = false;
+	clusterSize = 16;
+	rangeCacheSize = 8;
+	flowFieldCacheSize = 4;
+	nextTrackedPath = 0;
+	range = nullptr;
+	asyncCompletionTime = 0.0f;
+	contextPool = MakeShared<FGridSearchContextPool, ESPMode::ThreadSafe>();
+	stateInstances.Add(CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("TileInstances")));
+	stateInstances.Add(CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("HighlightedInstances")));
+	stateInstances.Add(CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("PathInstances")));
+	for (int i = 0; i < stateInstances.Num(); i++)
+	{
+		stateInstances[i]->SetupAttachment(root);
+	}
 
 }
 
@@ -26,287 +65,992 @@ AGridManager::AGridManager()
 void AGridManager::BeginPlay()
 {
 	Super::BeginPlay();
+	SCOPE_CYCLE_COUNTER(STAT_GridManagerBuild);
 
-	FVector rowTileLoc;
-	FVector columnTileLoc;
-	int neighborCounter = 0; //The tile on the right most part of the grid does not add the next tile as a neighbor
-	if (tileRef)
+	//Neighbors are implicit in the grid map so there's no wiring to do here
+	if (!LoadBakedGrid())
 	{
-		//The row tiles are the ones of the left most part of the grid. Everything else is a column tile
-		//The row tiles act as anchors, and will not have any functionality in the game itself
-		for (int r = 0; r < rowsNum; r++)
+		grid.Init(FMath::Max(width, 0), FMath::Max(height, 0));
+		RasterizeTerrain();
+	}
+	highlighted.Init(grid.Num(), false);
+	obstacleCoverage.Init(0, grid.Num());
+	obstacleFootprints.Reset();
+	tileStates.Init((uint8)EGridTileState::Default, grid.Num());
+	rangeCache.SetCapacity(rangeCacheSize);
+	flowFields.SetCapacity(flowFieldCacheSize);
+	if (tileRef && bStreamTiles)
+	{
+		//Nothing gets drawn until its chunk is loaded
+		if (bInstancedTiles)
 		{
-			rowTileLoc = FVector(r*tileSize + GetActorLocation().X, GetActorLocation().Y, GetActorLocation().Z);
-			ATile* tiler = GetWorld()->SpawnActor<ATile>(tileRef, rowTileLoc, FRotator::ZeroRotator);
-			tiler->SetGridManager(this);
-			rowTiles.Push(tiler);
-			for (int c = 1; c < columnsNum; c++) //We start at 1 because the row tiles have already created one column
-			{
-				columnTileLoc = FVector(rowTileLoc.X, c*tileSize +  rowTileLoc.Y, rowTileLoc.Z);
+			SetupInstances();
+			tileInstances.Init(INDEX_NONE, grid.Num());
+		}
+		else
+		{
+			tileActors.Init(nullptr, grid.Num());
+		}
+		chunks.Init(grid.GetWidth(), grid.GetHeight(), chunkSize);
+		residentChunks.Init(chunks.Num(), false);
+		streamingChunk = INDEX_NONE;
+		SetActorTickEnabled(true);
+	}
+	else if (tileRef && bInstancedTiles)
+	{
+		//One instance per tile, no actors
+		SetupInstances();
+		tileInstances.SetNumUninitialized(grid.Num());
+		instanceTiles[(int32)EGridTileState::Default].SetNumUninitialized(grid.Num());
+		for (int32 i = 0; i < grid.Num(); i++)
+		{
+			tileInstances[i] = stateInstances[(int32)EGridTileState::Default]->AddInstanceWorldSpace(GetTileTransform(i));
+			instanceTiles[(int32)EGridTileState::Default][tileInstances[i]] = i;
+		}
+	}
+	else if (tileRef)
+	{
+		tileActors.SetNumUninitialized(grid.Num());
+		for (int32 i = 0; i < grid.Num(); i++)
+		{
+			tileActors[i] = SpawnTileActor(i);
+		}
+	}
 
-				ATile* tilec = GetWorld()->SpawnActor<ATile>(tileRef, columnTileLoc, FRotator::ZeroRotator);
-				tilec->SetGridManager(this);
-				columnTiles.Push(tilec);
-			}
+	//A baked grid already has the obstacles blocked, they're only registered here so they can move or go away later
+	RasterizeObstacles();
+	for (int32 i = 0; i < spawnedBlockedTiles.Num(); i++)
+	{
+		if (grid.IsValidIndex(spawnedBlockedTiles[i]))
+		{
+			grid.SetTraversable(spawnedBlockedTiles[i], false);
 		}
-		
-		//Update neighbors in column tile (rows are only anchors)
-		for (int i = 0; i < columnTiles.Num(); i++)
+	}
+	spawnedBlockedTiles.Empty();
+	if (clusterSize > 0 && !hierarchy.IsBuiltFor(grid, clusterSize))
+	{
+		hierarchy.Build(grid, clusterSize);
+	}
+}
+
+void AGridManager::SetupSpawned(int32 width_, int32 height_, bool bStreamTiles_, const TArray<int32>& blockedTiles_)
+{
+	width = width_;
+	height = height_;
+	bStreamTiles = bStreamTiles_;
+	spawnedBlockedTiles = blockedTiles_;
+	//A template's baked file is for its own board
+	bakedGrid.FilePath.Empty();
+}
+
+FString AGridManager::GetBakedGridPath() const
+{
+	return bakedGrid.FilePath.IsEmpty() ? FString() : FPaths::Combine(FPaths::ProjectContentDir(), bakedGrid.FilePath);
+}
+
+bool AGridManager::LoadBakedGrid()
+{
+	const FString path = GetBakedGridPath();
+	if (path.IsEmpty())
+		return false;
+
+	FGridFile file;
+	if (!file.Open(*path))
+	{
+		UE_LOG(LogGridTut, Warning, TEXT("%s: can't read baked grid %s"), *GetName(), *path);
+		return false;
+	}
+	if (file.GetWidth() != width || file.GetHeight() != height)
+	{
+		UE_LOG(LogGridTut, Warning, TEXT("%s: baked grid %s is %dx%d instead of %dx%d, bake it again"), *GetName(), *path, file.GetWidth(), file.GetHeight(), width, height);
+		return false;
+	}
+	if (!file.LoadGrid(grid))
+		return false;
+
+	//Without a matching hierarchy in the file it's built as usual
+	if (clusterSize > 0)
+	{
+		file.LoadHierarchy(grid, clusterSize, hierarchy);
+	}
+	return true;
+}
+
+void AGridManager::BakeGrid()
+{
+	if (bakedGrid.FilePath.IsEmpty())
+	{
+		Modify();
+		bakedGrid.FilePath = FString::Printf(TEXT("Grids/%s_%s.grid"), *FPaths::GetBaseFilename(GetOutermost()->GetName()), *GetName());
+	}
+
+	grid.Init(FMath::Max(width, 0), FMath::Max(height, 0));
+	obstacleCoverage.Init(0, grid.Num());
+	obstacleFootprints.Reset();
+	RasterizeTerrain();
+	RasterizeObstacles();
+	if (clusterSize > 0)
+	{
+		hierarchy.Build(grid, clusterSize);
+	}
+
+	const FString path = GetBakedGridPath();
+	if (FGridFile::Save(*path, grid, clusterSize > 0 ? &hierarchy : nullptr))
+	{
+		UE_LOG(LogGridTut, Log, TEXT("%s: baked %dx%d grid to %s"), *GetName(), grid.GetWidth(), grid.GetHeight(), *path);
+	}
+	else
+	{
+		UE_LOG(LogGridTut, Error, TEXT("%s: couldn't write baked grid %s"), *GetName(), *path);
+	}
+
+	//The editor copy doesn't keep any of it, so obstacles moved in the editor don't write into a stale grid
+	obstacleCoverage.Empty();
+	obstacleFootprints.Empty();
+	grid.Init(0, 0);
+}
+
+void AGridManager::SetupInstances()
+{
+	//Copy the mesh, materials and collision of the tile blueprint so both modes look the same
+	ATile* tileDefaults = tileRef->GetDefaultObject<ATile>();
+	UStaticMeshComponent* tileMesh = tileDefaults->GetMesh();
+	tileMeshTransform = tileMesh->GetRelativeTransform();
+
+	UMaterialInterface* stateMaterials[(int32)EGridTileState::Num] =
+	{
+		tileDefaults->GetOriginalMaterial(),
+		tileDefaults->GetHighlightedMaterial(),
+		tileDefaults->GetPathMaterial()
+	};
+
+	for (int i = 0; i < stateInstances.Num(); i++)
+	{
+		stateInstances[i]->SetStaticMesh(tileMesh->GetStaticMesh());
+		stateInstances[i]->SetCollisionProfileName(tileMesh->GetCollisionProfileName());
+		for (int m = 0; m < tileMesh->GetNumMaterials(); m++)
+		{
+			stateInstances[i]->SetMaterial(m, tileMesh->GetMaterial(m));
+		}
+		if (stateMaterials[i])
+		{
+			stateInstances[i]->SetMaterial(2, stateMaterials[i]);
+		}
+	}
+}
+
+void AGridManager::RasterizeObstacles()
+{
+	//One pass per obstacle over the tiles under it, startup doesn't depend on the number of tiles anymore
+	for (TActorIterator<AObstacle> it(GetWorld()); it; ++it)
+	{
+		UpdateObstacle(*it);
+	}
+}
+
+void AGridManager::RasterizeTerrain()
+{
+	//Tiles start at the default cost and the cheapest area over a tile wins
+	TArray<uint8> costs;
+	costs.Init(0, grid.Num());
+	TArray<int32> footprint;
+	for (TActorIterator<ATerrainArea> it(GetWorld()); it; ++it)
+	{
+		const uint8 cost = FMath::Max<uint8>(it->GetCost(), 1);
+		GetBoxFootprint(it->GetBox(), footprint);
+		for (int32 i = 0; i < footprint.Num(); i++)
+		{
+			uint8& tileCost = costs[footprint[i]];
+			tileCost = tileCost == 0 ? cost : FMath::Min(tileCost, cost);
+		}
+	}
+	for (int32 i = 0; i < costs.Num(); i++)
+	{
+		if (costs[i] == 0)
+			costs[i] = GridCost::DefaultTerrain;
+	}
+	grid.SetTerrainCosts(costs.GetData());
+}
+
+void AGridManager::GetBoxFootprint(UBoxComponent* box_, TArray<int32>& outTiles_)
+{
+	outTiles_.Reset();
+	if (!box_ || grid.Num() == 0)
+		return;
+
+	//Boxes only count if they reach into the space right above the board
+	const FVector origin = GetActorLocation();
+	const FBox bounds = box_->Bounds.GetBox();
+	if (bounds.Max.Z < origin.Z || bounds.Min.Z > origin.Z + 400.0f)
+		return;
+
+	//Tiles whose square touches the bounds
+	const float halfTile = tileSize * 0.5f;
+	const int32 minX = FMath::Max(FMath::FloorToInt((bounds.Min.Y - origin.Y + halfTile) / tileSize), 0);
+	const int32 maxX = FMath::Min(FMath::FloorToInt((bounds.Max.Y - origin.Y + halfTile) / tileSize), grid.GetWidth() - 1);
+	const int32 minY = FMath::Max(FMath::FloorToInt((bounds.Min.X - origin.X + halfTile) / tileSize), 0);
+	const int32 maxY = FMath::Min(FMath::FloorToInt((bounds.Max.X - origin.X + halfTile) / tileSize), grid.GetHeight() - 1);
+
+	//The footprint is the box seen from above, so boxes are expected to only be turned around Z.
+	//A tile is covered if its square and the footprint overlap on all 4 separating axes
+	const FTransform& boxTransform = box_->GetComponentTransform();
+	const FVector2D center(boxTransform.GetLocation());
+	const FVector2D axisU = FVector2D(boxTransform.GetUnitAxis(EAxis::X)).GetSafeNormal();
+	const FVector2D axisV(-axisU.Y, axisU.X);
+	const FVector extent = box_->GetScaledBoxExtent();
+	const FVector2D axes[4] = { FVector2D(1.0f, 0.0f), FVector2D(0.0f, 1.0f), axisU, axisV };
+	//Only touching the edge of a tile doesn't cover it
+	const float tolerance = tileSize * 0.01f;
+
+	for (int32 y = minY; y <= maxY; y++)
+	{
+		for (int32 x = minX; x <= maxX; x++)
 		{
-			if (columnTiles[i] != nullptr)
+			const int32 tile = grid.ToIndex(x, y);
+			const FVector2D offset = FVector2D(GetTileLocation(tile)) - center;
+			bool bOverlaps = true;
+			for (int32 a = 0; a < 4 && bOverlaps; a++)
 			{
-				neighborCounter++;
-				
-				//Add the tile to the right
-				//Make sure we're not going off the grid and make sure that the right most tile does not add the next tile as a neighbor
-				if (i + 1 < columnTiles.Num() && neighborCounter < columnsNum - 1)
-				{
-					if (columnTiles[i + 1] != nullptr)
-					{
-						columnTiles[i]->AddImmediateNeighbor(columnTiles[i + 1]);
-					}
-				}
-				//Add the tile above the current tile
-				if (i + columnsNum - 1 < columnTiles.Num())
-				{
-					if (columnTiles[i + columnsNum - 1] != nullptr)
-					{
-						columnTiles[i]->AddImmediateNeighbor(columnTiles[i + columnsNum - 1]);
-					}
-				}
-
-				//Add diagonal tile to the right of the current tile
-				if (i + columnsNum< columnTiles.Num() && neighborCounter < columnsNum - 1)
-				{
-					if (columnTiles[i + columnsNum] != nullptr)
-					{
-						columnTiles[i]->AddDiagonalNeighbor(columnTiles[i + columnsNum]);
-					}
-				}
-
-				//Add diagonal tile to the left of the current tile
-				if (i + columnsNum - 2 < columnTiles.Num() && neighborCounter > 1)
-				{
-					if (columnTiles[i + columnsNum - 2] != nullptr)
-					{
-						columnTiles[i]->AddDiagonalNeighbor(columnTiles[i + columnsNum - 2]);
-					}
-				}
-
-				//Reached the right most tile, reset the neighbor counter
-				if (neighborCounter == columnsNum - 1) 
-				{
-					neighborCounter = 0;
-				}
+				const float tileRadius = halfTile * (FMath::Abs(axes[a].X) + FMath::Abs(axes[a].Y));
+				const float boxRadius = extent.X * FMath::Abs(axisU | axes[a]) + extent.Y * FMath::Abs(axisV | axes[a]);
+				bOverlaps = tileRadius + boxRadius - FMath::Abs(offset | axes[a]) > tolerance;
+			}
+			if (bOverlaps)
+			{
+				outTiles_.Add(tile);
 			}
 		}
 	}
-	
 }
 
-void AGridManager::UpdateCurrentTile(ATile* tile_, int rowSpeed_, int columnSpeed_, int depth_)
+FTransform AGridManager::GetTileTransform(int32 index_)
+{
+	return tileMeshTransform * FTransform(GetTileLocation(index_));
+}
+
+void AGridManager::SetTileState(int32 index_, EGridTileState state_)
+{
+	if (tileStates[index_] == (uint8)state_)
+		return;
+
+	//Tiles in chunks that aren't loaded only remember their state until they are
+	const bool bHasInstance = tileInstances.IsValidIndex(index_) && tileInstances[index_] != INDEX_NONE;
+	if (bHasInstance)
+	{
+		RemoveTileInstance(index_);
+	}
+	tileStates[index_] = (uint8)state_;
+	if (bHasInstance)
+	{
+		AddTileInstance(index_);
+	}
+	else if (ATile* tile = GetTileActor(index_))
+	{
+		ApplyTileActorState(tile, state_);
+	}
+}
+
+void AGridManager::AddTileInstance(int32 index_)
+{
+	const int32 state = tileStates[index_];
+	tileInstances[index_] = stateInstances[state]->AddInstanceWorldSpace(GetTileTransform(index_));
+	instanceTiles[state].Add(index_);
+}
+
+void AGridManager::RemoveTileInstance(int32 index_)
+{
+	//Swap remove from the component so no other instance has to shift
+	const int32 state = tileStates[index_];
+	UInstancedStaticMeshComponent* component = stateInstances[state];
+	const int32 instance = tileInstances[index_];
+	const int32 lastInstance = instanceTiles[state].Num() - 1;
+	if (instance != lastInstance)
+	{
+		FTransform lastTransform;
+		component->GetInstanceTransform(lastInstance, lastTransform, true);
+		component->UpdateInstanceTransform(instance, lastTransform, true);
+		instanceTiles[state][instance] = instanceTiles[state][lastInstance];
+		tileInstances[instanceTiles[state][instance]] = instance;
+	}
+	component->RemoveInstance(lastInstance);
+	instanceTiles[state].Pop(false);
+	tileInstances[index_] = INDEX_NONE;
+}
+
+ATile* AGridManager::SpawnTileActor(int32 index_)
 {
-	if (tile_)
+	//Deferred so the tile knows its index before its BeginPlay
+	const FTransform tileTransform(GetTileLocation(index_));
+	ATile* tile = GetWorld()->SpawnActorDeferred<ATile>(tileRef, tileTransform);
+	tile->SetGridManager(this, index_);
+	tile->FinishSpawning(tileTransform);
+	if (tileStates[index_] != (uint8)EGridTileState::Default)
 	{
-		//Check if it's a row tile or a column tile
-		if (columnTiles.Contains(tile_))
+		ApplyTileActorState(tile, (EGridTileState)tileStates[index_]);
+	}
+	return tile;
+}
+
+void AGridManager::ApplyTileActorState(ATile* tile_, EGridTileState state_)
+{
+	switch (state_)
+	{
+	case EGridTileState::Default:
+		tile_->NotHighlighted();
+		break;
+	case EGridTileState::Highlighted:
+		tile_->Highlighted();
+		break;
+	case EGridTileState::Path:
+		tile_->HighlightPath();
+		break;
+	}
+}
+
+void AGridManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (bStreamTiles)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GridStreaming);
+		UpdateStreaming(tilesPerTick);
+	}
+}
+
+void AGridManager::UpdateStreaming(int32 maxTiles_)
+{
+	//The board is looked at through every player's view target, plus whatever asked to stay loaded
+	TArray<FVector2D> sources;
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		APlayerController* playerController = it->Get();
+		if (playerController && playerController->GetViewTarget())
 		{
-			//Get the column tile index
-			 tileIndexInColumn = columnTiles.IndexOfByKey(tile_);
-			 //Get the row tile index
-			 tileIndexInRows = ConvertColumnToRow(tileIndexInColumn);
+			sources.Add(FVector2D(playerController->GetViewTarget()->GetActorLocation()));
 		}
-		else if (rowTiles.Contains(tile_))
+	}
+	streamingSources.RemoveAll([](const TWeakObjectPtr<AActor>& source_) { return !source_.IsValid(); });
+	for (int32 i = 0; i < streamingSources.Num(); i++)
+	{
+		sources.Add(FVector2D(streamingSources[i]->GetActorLocation()));
+	}
+
+	const float loadRadiusSquared = FMath::Square(streamingRadius);
+	const float evictRadiusSquared = FMath::Square(streamingRadius * 1.25f);
+	int32 budget = maxTiles_;
+
+	//A chunk left half done goes first. It turns around if it crossed a radius since, otherwise it keeps going
+	if (streamingChunk != INDEX_NONE)
+	{
+		const float distanceSquared = GetChunkDistanceSquared(streamingChunk, sources);
+		const bool bIn = distanceSquared <= loadRadiusSquared || (bStreamingIn && distanceSquared <= evictRadiusSquared);
+		if (bIn ? !LoadChunk(streamingChunk, budget) : !EvictChunk(streamingChunk, budget))
+			return;
+	}
+
+	TArray<TPair<float, int32>> toLoad;
+	TArray<int32> toEvict;
+	for (int32 c = 0; c < chunks.Num(); c++)
+	{
+		const float distanceSquared = GetChunkDistanceSquared(c, sources);
+		if (!residentChunks.Get(c) && distanceSquared <= loadRadiusSquared)
 		{
-			//Get the row tile index
-			//UE_LOG(LogTemp, Warning, TEXT("Row Tile"));
-			tileIndexInRows = rowTiles.IndexOfByKey(tile_);
-			//Get the column tile index
-			tileIndexInColumn = ConvertRowTocolumn(tileIndexInRows);
+			toLoad.Add(TPair<float, int32>(distanceSquared, c));
 		}
-		HighlightTiles(rowSpeed_, depth_);
+		else if (residentChunks.Get(c) && distanceSquared > evictRadiusSquared)
+		{
+			toEvict.Add(c);
+		}
+	}
+
+	//Evicting first keeps the instance count down, then the closest chunks come in first
+	for (int32 i = 0; i < toEvict.Num(); i++)
+	{
+		if (!EvictChunk(toEvict[i], budget))
+			return;
+	}
+	toLoad.Sort([](const TPair<float, int32>& a_, const TPair<float, int32>& b_) { return a_.Key < b_.Key; });
+	for (int32 i = 0; i < toLoad.Num(); i++)
+	{
+		if (!LoadChunk(toLoad[i].Value, budget))
+			return;
+	}
+}
+
+float AGridManager::GetChunkDistanceSquared(int32 chunk_, const TArray<FVector2D>& sources_)
+{
+	//Distance to the closest point of the chunk's area. Tile (x, y) is centered x tiles along Y and y tiles along X from the manager
+	const FGridRect rect = chunks.GetRect(chunk_);
+	const FVector origin = GetActorLocation();
+	const float halfTile = tileSize * 0.5f;
+	const FVector2D rectMin(origin.X + rect.minY * tileSize - halfTile, origin.Y + rect.minX * tileSize - halfTile);
+	const FVector2D rectMax(origin.X + rect.maxY * tileSize + halfTile, origin.Y + rect.maxX * tileSize + halfTile);
+
+	float closest = MAX_flt;
+	for (int32 i = 0; i < sources_.Num(); i++)
+	{
+		const FVector2D clamped(FMath::Clamp(sources_[i].X, rectMin.X, rectMax.X), FMath::Clamp(sources_[i].Y, rectMin.Y, rectMax.Y));
+		closest = FMath::Min(closest, FVector2D::DistSquared(sources_[i], clamped));
 	}
+	return closest;
 }
 
-void AGridManager::HighlightTiles(int rowSpeed_, int depth_)
+bool AGridManager::LoadChunk(int32 chunk_, int32& budget_)
 {
-	int localDepth = depth_;
-	columnOffset = tileIndexInColumn - ConvertRowTocolumn(tileIndexInRows);
-	//Rows going upwards
-	for (int i = tileIndexInRows; i < tileIndexInRows + rowSpeed_ && i < rowsNum; i++)
+	const FGridRect rect = chunks.GetRect(chunk_);
+	const int32 numTiles = rect.GetWidth() * rect.GetHeight();
+	if (streamingChunk != chunk_)
 	{
-		tileIndexInColumn = ConvertRowTocolumn(i) + columnOffset;
-		if (tileIndexInColumn < columnTiles.Num())
+		check(streamingChunk == INDEX_NONE);
+		streamingChunk = chunk_;
+		streamedTiles = 0;
+	}
+	bStreamingIn = true;
+
+	for (; streamedTiles < numTiles && budget_ > 0; streamedTiles++, budget_--)
+	{
+		const int32 tile = grid.ToIndex(rect.minX + streamedTiles % rect.GetWidth(), rect.minY + streamedTiles / rect.GetWidth());
+		if (bInstancedTiles)
 		{
-			if (columnTiles[tileIndexInColumn] != nullptr)
-			{
-				if (columnTiles[tileIndexInColumn]->GetTraversable()) //If any of the tiles going upwards is non-traversable, then the next tile by default is non-traversable
-				{
-					columnTiles[tileIndexInColumn]->Highlighted();
-					highlightedTiles.Push(columnTiles[tileIndexInColumn]);
-				}
-				else
-				{
-					break;
-				}
-			}
+			AddTileInstance(tile);
+		}
+		else
+		{
+			tileActors[tile] = SpawnTileActor(tile);
 		}
 	}
-	for (int i = tileIndexInRows; i < tileIndexInRows + rowSpeed_ && i < rowsNum; i++)
+	if (streamedTiles < numTiles)
+		return false;
+
+	residentChunks.Set(chunk_, true);
+	streamingChunk = INDEX_NONE;
+	return true;
+}
+
+bool AGridManager::EvictChunk(int32 chunk_, int32& budget_)
+{
+	//Tiles go in the reverse order they were loaded in, so a chunk is always loaded up to streamedTiles
+	const FGridRect rect = chunks.GetRect(chunk_);
+	if (streamingChunk != chunk_)
 	{
-		tileIndexInColumn = ConvertRowTocolumn(i) + columnOffset;
-		if (tileIndexInColumn < columnTiles.Num())
+		check(streamingChunk == INDEX_NONE);
+		streamingChunk = chunk_;
+		streamedTiles = rect.GetWidth() * rect.GetHeight();
+		residentChunks.Set(chunk_, false);
+	}
+	bStreamingIn = false;
+
+	for (; streamedTiles > 0 && budget_ > 0; budget_--)
+	{
+		streamedTiles--;
+		const int32 tile = grid.ToIndex(rect.minX + streamedTiles % rect.GetWidth(), rect.minY + streamedTiles / rect.GetWidth());
+		if (bInstancedTiles)
 		{
-			if (columnTiles[tileIndexInColumn] != nullptr)
-			{
-				if (columnTiles[tileIndexInColumn]->GetHighlighted())
-				{
-					for (int d = 0; d < localDepth; d++)
-					{
-						//If it's on the same row, that's fine
-						if (ConvertColumnToRow(tileIndexInColumn + d) == i)
-						{
-							//	UE_LOG(LogTemp, Warning, TEXT("tileIndexInColumn + d %d "), tileIndexInColumn + d);
-							if (tileIndexInColumn + d > 0 && tileIndexInColumn + d < columnTiles.Num())
-							{
-								if (columnTiles[tileIndexInColumn + d - 1]->GetTraversable()) //Is the one to my left traversable?
-								{
-									columnTiles[tileIndexInColumn + d]->Highlighted();
-									highlightedTiles.Push(columnTiles[tileIndexInColumn + d]);
-								}
-								else
-								{
-									break;
-								}
-							}
-						}
-						if (ConvertColumnToRow(tileIndexInColumn - d) == i)
-						{
-							//	UE_LOG(LogTemp, Warning, TEXT("tileIndexInColumn - d %d "), tileIndexInColumn - d);
-							if (tileIndexInColumn - d > 0 && tileIndexInColumn - d + 1 < columnTiles.Num())
-							{
-								if (columnTiles[tileIndexInColumn - d + 1]->GetTraversable())
-								{
-									columnTiles[tileIndexInColumn - d]->Highlighted();
-									highlightedTiles.Push(columnTiles[tileIndexInColumn - d]);
-								}
-								else
-								{
-									break;
-								}
-							}
-						}
-					}
-				}
-			}
-			
+			RemoveTileInstance(tile);
+		}
+		else if (tileActors[tile])
+		{
+			tileActors[tile]->Destroy();
+			tileActors[tile] = nullptr;
 		}
-		localDepth--;
 	}
-	localDepth = depth_;
+	if (streamedTiles > 0)
+		return false;
+
+	streamingChunk = INDEX_NONE;
+	return true;
+}
+
+void AGridManager::AddStreamingSource(AActor* source_)
+{
+	streamingSources.AddUnique(source_);
+}
+
+void AGridManager::RemoveStreamingSource(AActor* source_)
+{
+	streamingSources.Remove(source_);
+}
+
+void AGridManager::UpdateCurrentTile(int32 tileIndex_, int32 budget_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridUpdateCurrentTile);
+	if (!grid.IsValidIndex(tileIndex_))
+		return;
+
+	//An async range finishing later would replace this one
+	if (rangeQuery.IsValid())
+	{
+		rangeQuery->Cancel();
+		rangeQuery.Reset();
+	}
+
+	range = &rangeCache.Find(grid, searchContext, tileIndex_, budget_);
+	HighlightTiles();
+}
+
+void AGridManager::UpdateCurrentTileAsync(int32 tileIndex_, int32 budget_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridUpdateCurrentTile);
+	if (!grid.IsValidIndex(tileIndex_))
+		return;
 
-		//Rows going downwards
+	if (rangeQuery.IsValid())
+	{
+		rangeQuery->Cancel();
+		rangeQuery.Reset();
+	}
 
-	for (int j = tileIndexInRows; j >= tileIndexInRows - rowSpeed_ && j >= 0; j--)
+	//Nothing to search for if the range is cached
+	if (const FGridReachability* cached = rangeCache.FindCached(grid.GetVersion(), tileIndex_, budget_))
 	{
-		tileIndexInColumn = ConvertRowTocolumn(j) + columnOffset;
+		range = cached;
+		HighlightTiles();
+		return;
+	}
 
-		if (tileIndexInColumn < columnTiles.Num())
+	TSharedRef<const FGridMap, ESPMode::ThreadSafe> snapshot = GetGridSnapshot();
+	TSharedRef<FGridReachability, ESPMode::ThreadSafe> result = MakeShared<FGridReachability, ESPMode::ThreadSafe>();
+	TWeakObjectPtr<AGridManager> weakThis(this);
+	rangeQuery = FGridAsyncQuery::Launch(contextPool.ToSharedRef(),
+		[snapshot, result, tileIndex_, budget_](FGridSearchContext& context_)
+		{
+			result->Compute(*snapshot, context_, tileIndex_, budget_);
+		},
+		[weakThis, result]()
 		{
-			if (columnTiles[tileIndexInColumn] != nullptr)
+			if (AGridManager* manager = weakThis.Get())
 			{
-				if (columnTiles[tileIndexInColumn]->GetTraversable())
-				{
-					columnTiles[tileIndexInColumn]->Highlighted();
-					highlightedTiles.Push(columnTiles[tileIndexInColumn]);
-				}
-				else
-				{
-					break;
-				}
+				const double start = FPlatformTime::Seconds();
+				manager->rangeQuery.Reset();
+				manager->range = &manager->rangeCache.Add(MoveTemp(*result));
+				manager->HighlightTiles();
+				manager->EndAsyncCompletion(start);
 			}
+		});
+}
+
+void AGridManager::UpdateCurrentTileSteps(int32 tileIndex_, int32 steps_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridUpdateCurrentTile);
+	if (!grid.IsValidIndex(tileIndex_))
+		return;
+
+	if (rangeQuery.IsValid())
+	{
+		rangeQuery->Cancel();
+		rangeQuery.Reset();
+	}
+	range = nullptr;
+
+	stepRange.Compute(grid, tileIndex_, steps_);
+	const FGridBitset& tiles = stepRange.GetMask();
+	for (int32 i = tiles.FindNextSetBit(0); i != INDEX_NONE; i = tiles.FindNextSetBit(i + 1))
+	{
+		HighlightTile(i);
+	}
+	SET_DWORD_STAT(STAT_GridTilesHighlighted, highlightedTiles.Num());
+}
+
+void AGridManager::HighlightTiles()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridHighlightTiles);
+	//The range only holds tiles that can actually be walked to, around obstacles included
+	if (!range)
+		return;
+	const TArray<int32>& tiles = range->GetTiles();
+	for (int i = 0; i < tiles.Num(); i++)
+	{
+		HighlightTile(tiles[i]);
+	}
+	SET_DWORD_STAT(STAT_GridTilesHighlighted, highlightedTiles.Num());
+}
+
+void AGridManager::ClearHighlighted()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridClearHighlighted);
+	if (highlightedTiles.Num() > 0)
+	{
+		for (int i = 0; i < highlightedTiles.Num(); i++)
+		{
+			SetTileState(highlightedTiles[i], EGridTileState::Default);
+			highlighted.Set(highlightedTiles[i], false);
 		}
+
+		highlightedTiles.Empty();
+		SET_DWORD_STAT(STAT_GridTilesHighlighted, 0);
+	}
+	range = nullptr;
+	if (rangeQuery.IsValid())
+	{
+		rangeQuery->Cancel();
+		rangeQuery.Reset();
 	}
-	
-	for (int j = tileIndexInRows; j >= tileIndexInRows - rowSpeed_ && j >= 0; j--)
+}
+
+void AGridManager::HighlightTile(int32 index_)
+{
+	//Only traversable tiles can be highlighted, and each tile only once
+	if (grid.IsTraversable(index_) && !highlighted.Get(index_))
+	{
+		highlighted.Set(index_, true);
+		highlightedTiles.Push(index_);
+		SetTileState(index_, EGridTileState::Highlighted);
+	}
+}
+
+FGridMap& AGridManager::GetGrid()
+{
+	return grid;
+}
+
+ATile* AGridManager::GetTileActor(int32 index_)
+{
+	return tileActors.IsValidIndex(index_) ? tileActors[index_] : nullptr;
+}
+
+FVector AGridManager::GetTileLocation(int32 index_)
+{
+	return GetActorLocation() + FVector(grid.GetY(index_) * tileSize, grid.GetX(index_) * tileSize, 0.0f);
+}
+
+bool AGridManager::IsTileHighlighted(int32 index_)
+{
+	return grid.IsValidIndex(index_) && highlighted.Get(index_);
+}
+
+void AGridManager::HighlightPathTile(int32 index_)
+{
+	SetTileState(index_, EGridTileState::Path);
+}
+
+int32 AGridManager::GetTileAtLocation(const FVector& location_)
+{
+	if (tileSize <= 0.0f)
+		return INDEX_NONE;
+
+	//Tiles are centered on their location so round to the closest one
+	const FVector local = location_ - GetActorLocation();
+	const int32 x = FMath::FloorToInt(local.Y / tileSize + 0.5f);
+	const int32 y = FMath::FloorToInt(local.X / tileSize + 0.5f);
+	return grid.IsValid(x, y) ? grid.ToIndex(x, y) : INDEX_NONE;
+}
+
+bool AGridManager::IntersectBoard(const FVector& origin_, const FVector& direction_, FVector& outLocation_)
+{
+	//The board is the horizontal plane through the manager
+	if (FMath::IsNearlyZero(direction_.Z))
+		return false;
+
+	const float distance = (GetActorLocation().Z - origin_.Z) / direction_.Z;
+	if (distance < 0.0f)
+		return false;
+
+	outLocation_ = origin_ + direction_ * distance;
+	return true;
+}
+
+AGridManager* AGridManager::FindTileAtLocation(UWorld* world_, const FVector& location_, int32& tileIndex_)
+{
+	//If boards are stacked, take the one closest in height
+	tileIndex_ = INDEX_NONE;
+	AGridManager* closest = nullptr;
+	float closestHeight = MAX_flt;
+	for (TActorIterator<AGridManager> it(world_); it; ++it)
+	{
+		const int32 tile = it->GetTileAtLocation(location_);
+		const float height = FMath::Abs(location_.Z - it->GetActorLocation().Z);
+		if (tile != INDEX_NONE && height < closestHeight)
+		{
+			closest = *it;
+			closestHeight = height;
+			tileIndex_ = tile;
+		}
+	}
+	return closest;
+}
+
+AGridManager* AGridManager::FindTileFromRay(UWorld* world_, const FVector& origin_, const FVector& direction_, int32& tileIndex_)
+{
+	tileIndex_ = INDEX_NONE;
+	AGridManager* closest = nullptr;
+	float closestDistance = MAX_flt;
+	for (TActorIterator<AGridManager> it(world_); it; ++it)
+	{
+		FVector location;
+		if (!it->IntersectBoard(origin_, direction_, location))
+			continue;
+
+		const int32 tile = it->GetTileAtLocation(location);
+		const float distance = FVector::DistSquared(origin_, location);
+		if (tile != INDEX_NONE && distance < closestDistance)
+		{
+			closest = *it;
+			closestDistance = distance;
+			tileIndex_ = tile;
+		}
+	}
+	return closest;
+}
+
+bool AGridManager::FindPath(int32 start_, int32 goal_, TArray<int32>& outPath_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridFindPath);
+	//The range is only trusted if nothing changed on the grid since it was computed
+	bool bFound;
+	if (range && range->GetOrigin() == start_ && range->GetVersion() == grid.GetVersion())
+	{
+		bFound = range->GetPath(goal_, outPath_);
+	}
+	else
+	{
+		bFound = SearchPath(pathMode, grid, searchContext, start_, goal_, &highlighted, outPath_);
+	}
+	SET_DWORD_STAT(STAT_GridPathLength, outPath_.Num());
+	return bFound;
+}
+
+FGridAsyncQueryPtr AGridManager::FindPathAsync(int32 start_, int32 goal_, TFunction<void(bool, const TArray<int32>&)> onComplete_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridFindPath);
+	//Walking up the range's parent tree is cheap enough to stay on the game thread
+	if (range && range->GetOrigin() == start_ && range->GetVersion() == grid.GetVersion())
 	{
-		tileIndexInColumn = ConvertRowTocolumn(j) + columnOffset;
+		TArray<int32> tiles;
+		const bool bFound = range->GetPath(goal_, tiles);
+		SET_DWORD_STAT(STAT_GridPathLength, tiles.Num());
+		onComplete_(bFound, tiles);
+		return nullptr;
+	}
 
-		if (tileIndexInColumn < columnTiles.Num())
+	struct FPathResult
+	{
+		bool bFound = false;
+		TArray<int32> path;
+	};
+	TSharedRef<const FGridMap, ESPMode::ThreadSafe> snapshot = GetGridSnapshot();
+	TSharedRef<FGridBitset, ESPMode::ThreadSafe> allowed = MakeShared<FGridBitset, ESPMode::ThreadSafe>(highlighted);
+	TSharedRef<FPathResult, ESPMode::ThreadSafe> result = MakeShared<FPathResult, ESPMode::ThreadSafe>();
+	const EGridPathMode mode = pathMode;
+	TWeakObjectPtr<AGridManager> weakThis(this);
+	return FGridAsyncQuery::Launch(contextPool.ToSharedRef(),
+		[snapshot, allowed, result, mode, start_, goal_](FGridSearchContext& context_)
+		{
+			result->bFound = SearchPath(mode, *snapshot, context_, start_, goal_, &allowed.Get(), result->path);
+		},
+		[weakThis, result, onComplete_]()
 		{
-			if (columnTiles[tileIndexInColumn] != nullptr)
+			const double start = FPlatformTime::Seconds();
+			SET_DWORD_STAT(STAT_GridPathLength, result->path.Num());
+			onComplete_(result->bFound, result->path);
+			if (AGridManager* manager = weakThis.Get())
 			{
-				if (columnTiles[tileIndexInColumn]->GetHighlighted())
-				{
-					for (int d = 0; d < localDepth; d++)
-					{
-						//If it's on the same row, that's fine
-						if (ConvertColumnToRow(tileIndexInColumn + d) == j)
-						{
-							if (tileIndexInColumn + d > 0 && tileIndexInColumn + d < columnTiles.Num())
-							{
-								if (columnTiles[tileIndexInColumn + d - 1]->GetTraversable())
-								{
-									columnTiles[tileIndexInColumn + d]->Highlighted();
-									highlightedTiles.Push(columnTiles[tileIndexInColumn + d]);
-								}
-								else
-								{
-									break;
-								}
-							}
-						}
-						if (ConvertColumnToRow(tileIndexInColumn - d) == j)
-						{
-							if (tileIndexInColumn - d > 0 && tileIndexInColumn - d + 1 < columnTiles.Num())
-							{
-								if (columnTiles[tileIndexInColumn - d + 1]->GetTraversable())
-								{
-									columnTiles[tileIndexInColumn - d]->Highlighted();
-									highlightedTiles.Push(columnTiles[tileIndexInColumn - d]);
-								}
-								else
-								{
-									break;
-								}
-							}
-						}
-					}
-				}
+				manager->EndAsyncCompletion(start);
 			}
+		});
+}
+
+void AGridManager::EndAsyncCompletion(double startTime_)
+{
+	asyncCompletionTime += (float)((FPlatformTime::Seconds() - startTime_) * 1000.0);
+}
+
+float AGridManager::ConsumeAsyncCompletionTime()
+{
+	const float time = asyncCompletionTime;
+	asyncCompletionTime = 0.0f;
+	return time;
+}
+
+void AGridManager::GetWaypoints(int32 start_, const TArray<int32>& path_, TArray<int32>& outWaypoints_)
+{
+	if (!bAnyAnglePaths)
+	{
+		outWaypoints_ = path_;
+		return;
+	}
+	//Shortcuts stay inside the movement range while one is shown, like the paths themselves
+	FGridAnyAngle::ReducePath(grid, start_, path_, highlightedTiles.Num() > 0 ? &highlighted : nullptr, outWaypoints_);
+}
+
+bool AGridManager::SearchPath(EGridPathMode pathMode_, const FGridMap& grid_, FGridSearchContext& context_, int32 start_, int32 goal_, const FGridBitset* allowed_, TArray<int32>& outPath_)
+{
+	switch (pathMode_)
+	{
+	case EGridPathMode::JumpPoint:
+		return FGridJumpPointSearch::FindPath(grid_, context_, start_, goal_, allowed_, outPath_);
+	default:
+		return FGridAStar::FindPath(grid_, context_, start_, goal_, allowed_, outPath_);
+	}
+}
+
+TSharedRef<const FGridMap, ESPMode::ThreadSafe> AGridManager::GetGridSnapshot()
+{
+	//Queries in flight hold on to the old copy, so it never changes under them
+	if (!gridSnapshot.IsValid() || gridSnapshot->GetVersion() != grid.GetVersion())
+	{
+		gridSnapshot = MakeShared<FGridMap, ESPMode::ThreadSafe>(grid);
+	}
+	return gridSnapshot.ToSharedRef();
+}
+
+bool AGridManager::FindLongRangePath(int32 start_, int32 goal_, TArray<int32>& outPath_)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridFindPath);
+	if (hierarchy.IsBuilt())
+	{
+		hierarchy.Update(grid);
+		return hierarchy.FindPath(grid, searchContext, start_, goal_, outPath_);
+	}
+	return SearchPath(pathMode, grid, searchContext, start_, goal_, nullptr, outPath_);
+}
+
+void AGridManager::FindPaths(const TArray<FGridPathRequest>& requests_, TArray<FGridPathResult>& outResults_)
+{
+	//Bring the hierarchy up to date here, the workers only read it
+	const bool bUseHierarchy = hierarchy.IsBuilt();
+	if (bUseHierarchy)
+	{
+		hierarchy.Update(grid);
+	}
+
+	const EGridPathMode mode = pathMode;
+	FGridBatchSearch::FindPaths(*contextPool, requests_, [this, bUseHierarchy, mode](FGridSearchContext& context_, int32 start_, int32 goal_, TArray<int32>& outPath_)
+	{
+		if (bUseHierarchy)
+		{
+			return hierarchy.FindPath(grid, context_, start_, goal_, outPath_);
 		}
-		localDepth--;
+		return SearchPath(mode, grid, context_, start_, goal_, nullptr, outPath_);
+	}, outResults_);
+}
+
+const FGridFlowField& AGridManager::GetFlowField(int32 goal_)
+{
+	return flowFields.Find(grid, searchContext, goal_);
+}
+
+int32 AGridManager::GetNextStep(int32 tile_, int32 goal_)
+{
+	if (!grid.IsValidIndex(tile_) || !grid.IsValidIndex(goal_))
+		return INDEX_NONE;
+	return GetFlowField(goal_).GetNextTile(tile_);
+}
+
+bool AGridManager::HasLineOfSight(int32 from_, int32 to_)
+{
+	return FGridVisibility::HasLineOfSight(grid, from_, to_);
+}
+
+void AGridManager::HasLineOfSight(const TArray<FGridSightQuery>& queries_, TArray<bool>& outVisible_)
+{
+	FGridVisibility::HasLineOfSight(grid, queries_, outVisible_);
+}
+
+void AGridManager::GetVisibleTiles(const TArray<int32>& origins_, int32 radius_, TArray<FGridVisibility>& outResults_)
+{
+	FGridVisibility::Compute(grid, origins_, radius_, outResults_);
+}
+
+void AGridManager::SetTileTraversable(int32 index_, bool value_)
+{
+	if (grid.IsTraversable(index_) != value_)
+	{
+		grid.SetTraversable(index_, value_);
+		OnTileChanged(index_);
 	}
 }
 
-int AGridManager::ConvertRowTocolumn(int index_)
+void AGridManager::SetTileTerrainCost(int32 index_, uint8 cost_)
 {
-	//Under the assumption the grid is a square
-	if (index_ != 0)
+	cost_ = FMath::Max<uint8>(cost_, 1);
+	if (grid.GetTerrainCost(index_) != cost_)
 	{
-		return (index_ * columnsNum - index_);
+		grid.SetTerrainCost(index_, cost_);
+		OnTileChanged(index_);
 	}
-	return 0;
 }
-int AGridManager::ConvertColumnToRow(int index_)
+
+void AGridManager::OnTileChanged(int32 index_)
 {
-	//Under the assumption the grid is a square
-	if (index_ != 0)
+	hierarchy.MarkTileChanged(grid, index_);
+	for (TPair<int32, TUniquePtr<FGridDStarLite>>& tracked : trackedPaths)
 	{
-		return (index_ / (columnsNum - 1));
+		tracked.Value->NotifyTileChanged(grid, index_);
 	}
-	return 0;
 }
 
-void AGridManager::ClearHighlighted()
+void AGridManager::UpdateObstacle(AObstacle* obstacle_)
 {
-	if (highlightedTiles.Num() > 0)
+	//Nothing to write into before BeginPlay, the obstacle gets picked up there
+	if (!obstacle_ || obstacleCoverage.Num() == 0)
+		return;
+
+	TArray<int32> footprint;
+	GetBoxFootprint(obstacle_->GetBox(), footprint);
+	TArray<int32>* previous = obstacleFootprints.Find(obstacle_);
+	if (previous && *previous == footprint)
+		return;
+
+	//Cover the new tiles before uncovering the old ones so tiles in both never flip
+	for (int32 i = 0; i < footprint.Num(); i++)
 	{
-		for (int i = 0; i < highlightedTiles.Num(); i++)
+		if (obstacleCoverage[footprint[i]]++ == 0)
+		{
+			SetTileTraversable(footprint[i], false);
+		}
+	}
+	if (previous)
+	{
+		for (int32 i = 0; i < previous->Num(); i++)
 		{
-			highlightedTiles[i]->NotHighlighted();
+			if (--obstacleCoverage[(*previous)[i]] == 0)
+			{
+				SetTileTraversable((*previous)[i], true);
+			}
 		}
+	}
+	obstacleFootprints.Add(obstacle_, MoveTemp(footprint));
+}
 
-		highlightedTiles.Empty();
+void AGridManager::RemoveObstacle(AObstacle* obstacle_)
+{
+	TArray<int32> footprint;
+	if (!obstacleFootprints.RemoveAndCopyValue(obstacle_, footprint))
+		return;
+
+	for (int32 i = 0; i < footprint.Num(); i++)
+	{
+		if (--obstacleCoverage[footprint[i]] == 0)
+		{
+			SetTileTraversable(footprint[i], true);
+		}
 	}
 }
+
+int32 AGridManager::TrackPath(int32 start_, int32 goal_)
+{
+	if (!grid.IsValidIndex(start_) || !grid.IsValidIndex(goal_))
+		return INDEX_NONE;
+
+	TUniquePtr<FGridDStarLite> tracked = MakeUnique<FGridDStarLite>();
+	tracked->Init(grid, start_, goal_);
+	trackedPaths.Add(nextTrackedPath, MoveTemp(tracked));
+	return nextTrackedPath++;
+}
+
+bool AGridManager::GetTrackedPath(int32 handle_, int32 start_, TArray<int32>& outPath_)
+{
+	outPath_.Reset();
+	TUniquePtr<FGridDStarLite>* tracked = trackedPaths.Find(handle_);
+	if (!tracked)
+		return false;
+
+	(*tracked)->SetStart(grid, start_);
+	return (*tracked)->FindPath(grid, outPath_);
+}
+
+void AGridManager::StopTrackingPath(int32 handle_)
+{
+	trackedPaths.Remove(handle_);
+}
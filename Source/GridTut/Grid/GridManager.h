@@ -4,9 +4,41 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "GridMap.h"
+#include "GridAStar.h"
+#include "GridJumpPointSearch.h"
+#include "GridHierarchy.h"
+#include "GridReachability.h"
+#include "GridStepRange.h"
+#include "GridVisibility.h"
+#include "GridAnyAngle.h"
+#include "GridAsyncQuery.h"
+#include "GridBatchSearch.h"
+#include "GridFlowField.h"
+#include "GridDStarLite.h"
+#include "GridChunkLayout.h"
+#include "GridFile.h"
 #include "Tile.h"
 #include "GridManager.generated.h"
 
+//Visual state of a tile. In instanced mode each state is drawn by its own instanced mesh component
+enum class EGridTileState : uint8
+{
+	Default,
+	Highlighted,
+	Path,
+	Num
+};
+
+//Search used for path queries on this grid
+UENUM()
+enum class EGridPathMode : uint8
+{
+	AStar,
+	JumpPoint UMETA(DisplayName = "Jump Point Search")
+};
+
 UCLASS()
 class GRIDTUT_API AGridManager : public AActor
 {
@@ -19,32 +51,212 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void Tick(float DeltaTime) override;
 
 	UPROPERTY(EditAnywhere, Category = "Grid")
 		USceneComponent* root;
-	UPROPERTY(EditAnywhere, Category = "Grid")
-		float rowsNum;
-	UPROPERTY(EditAnywhere, Category = "Grid")
-		float columnsNum;
+	//Tiles along the actor's Y axis
+	UPROPERTY(EditAnywhere, Category = "Grid", meta = (ClampMin = "1"))
+		int32 width;
+	//Tiles along the actor's X axis
+	UPROPERTY(EditAnywhere, Category = "Grid", meta = (ClampMin = "1"))
+		int32 height;
 	UPROPERTY(EditAnywhere, Category = "Grid")
 		float tileSize;
 	UPROPERTY(EditAnywhere, Category = "Grid")
 		TSubclassOf<ATile> tileRef;
+	//Draw the board with instanced meshes using tileRef's mesh and materials instead of spawning one actor per tile
+	UPROPERTY(EditAnywhere, Category = "Grid")
+		bool bInstancedTiles;
+
+	//Only create tile visuals for the chunks around the view targets and streaming sources, for boards too big to draw whole.
+	//Traversability stays resident for the whole board at 1 bit per tile so searches don't care what's loaded
+	UPROPERTY(EditAnywhere, Category = "Grid|Streaming")
+		bool bStreamTiles;
+	UPROPERTY(EditAnywhere, Category = "Grid|Streaming", meta = (ClampMin = "1"))
+		int32 chunkSize;
+	//Chunks closer than this to a source get loaded. They're evicted a quarter further out so they don't flicker at the edge
+	UPROPERTY(EditAnywhere, Category = "Grid|Streaming")
+		float streamingRadius;
+	//Tile instances or actors created and destroyed per frame, so panning the camera never stalls a frame.
+	//A chunk that doesn't fit carries on next frame
+	UPROPERTY(EditAnywhere, Category = "Grid|Streaming", meta = (ClampMin = "1"))
+		int32 tilesPerTick;
+
+	UPROPERTY(EditAnywhere, Category = "Grid")
+		EGridPathMode pathMode;
+	//Units walk straight to the corners of their paths instead of from tile to tile
+	UPROPERTY(EditAnywhere, Category = "Grid")
+		bool bAnyAnglePaths;
+	//Size of the HPA* clusters used by long range queries, 0 disables the hierarchy
+	UPROPERTY(EditAnywhere, Category = "Grid")
+		int32 clusterSize;
+	//Size of the cache of movement ranges, so units can be selected again without recomputing anything
+	UPROPERTY(EditAnywhere, Category = "Grid")
+		int32 rangeCacheSize;
+	//How many goals keep their flow field around. Each field is 5 bytes per tile
+	UPROPERTY(EditAnywhere, Category = "Grid")
+		int32 flowFieldCacheSize;
 
-	TArray<ATile*> rowTiles;
-	TArray<ATile*> columnTiles;
-	TArray<ATile*> highlightedTiles;
-	int tileIndexInColumn;
-	int tileIndexInRows;
-	int columnOffset;
+	//Grid written by BakeGrid, relative to the content directory. It's loaded at startup instead of building the grid, terrain and hierarchy.
+	//The file isn't an asset, so its folder has to be in the project's additional non-asset directories to package
+	UPROPERTY(EditAnywhere, Category = "Grid|Baking", meta = (RelativeToGameContentDir, FilePathFilter = "grid"))
+		FFilePath bakedGrid;
 
-	int ConvertRowTocolumn(int index_);
-	int ConvertColumnToRow(int index_);
+	UPROPERTY(VisibleAnywhere, Category = "Grid")
+		TArray<UInstancedStaticMeshComponent*> stateInstances;
 
+	//Tile (x, y) sits x tiles along Y and y tiles along X from the manager, and its index is the same everywhere
+	FGridMap grid;
+	FGridBitset highlighted;
+	FGridSearchContext searchContext;
+	FGridHierarchy hierarchy;
+	FGridReachabilityCache rangeCache;
+	//Movement range of the selected tile. The highlighted tiles and the paths inside them both come from it
+	const FGridReachability* range;
+	FGridAsyncQueryPtr rangeQuery;
+	FGridStepRange stepRange;
+	FGridFlowFieldCache flowFields;
+
+	//How many obstacles cover each tile, so overlapping obstacles can come and go in any order
+	TArray<uint16> obstacleCoverage;
+	TMap<class AObstacle*, TArray<int32>> obstacleFootprints;
+	//Only set on boards spawned at runtime, see SetupSpawned
+	TArray<int32> spawnedBlockedTiles;
+	//Paths that get repaired as tiles change instead of searched again
+	TMap<int32, TUniquePtr<FGridDStarLite>> trackedPaths;
+	int32 nextTrackedPath;
+
+	//Async queries search a read-only copy of the grid, shared until the grid version changes
+	TSharedPtr<const FGridMap, ESPMode::ThreadSafe> gridSnapshot;
+	TSharedPtr<FGridSearchContextPool, ESPMode::ThreadSafe> contextPool;
+	//Game thread time of async completions since ConsumeAsyncCompletionTime, in ms
+	float asyncCompletionTime;
+	void EndAsyncCompletion(double startTime_);
+
+	TSharedRef<const FGridMap, ESPMode::ThreadSafe> GetGridSnapshot();
+	static bool SearchPath(EGridPathMode pathMode_, const FGridMap& grid_, FGridSearchContext& context_, int32 start_, int32 goal_, const FGridBitset* allowed_, TArray<int32>& outPath_);
+
+	//One actor per tile in grid index order when tiles aren't instanced
+	TArray<ATile*> tileActors;
+	TArray<int32> highlightedTiles;
+
+	void HighlightTile(int32 index_);
+
+	//Instanced rendering bookkeeping. A tile lives in the component of its current state
+	TArray<uint8> tileStates;
+	TArray<int32> tileInstances;
+	TArray<int32> instanceTiles[(int32)EGridTileState::Num];
+	FTransform tileMeshTransform;
+
+	FGridChunkLayout chunks;
+	//Only chunks with every tile loaded are resident
+	FGridBitset residentChunks;
+	//Chunk that's partly loaded or evicted. Its first streamedTiles tiles, row by row, have visuals
+	int32 streamingChunk;
+	int32 streamedTiles;
+	bool bStreamingIn;
+	TArray<TWeakObjectPtr<AActor>> streamingSources;
+
+	void UpdateStreaming(int32 maxTiles_);
+	//Both use up to budget_ tiles and return true once the chunk is done. An unfinished chunk picks up where it stopped
+	bool LoadChunk(int32 chunk_, int32& budget_);
+	bool EvictChunk(int32 chunk_, int32& budget_);
+	float GetChunkDistanceSquared(int32 chunk_, const TArray<FVector2D>& sources_);
+
+	void SetupInstances();
+	void AddTileInstance(int32 index_);
+	void RemoveTileInstance(int32 index_);
+	ATile* SpawnTileActor(int32 index_);
+	void ApplyTileActorState(ATile* tile_, EGridTileState state_);
+	//Marks the tiles under every obstacle's box as non-traversable
+	void RasterizeObstacles();
+	FString GetBakedGridPath() const;
+	//Grid and hierarchy from bakedGrid, false if there's no usable file
+	bool LoadBakedGrid();
+	//Sets every tile's terrain cost from the terrain areas in the level
+	void RasterizeTerrain();
+	//Tiles under a box seen from above, e.g. an obstacle's
+	void GetBoxFootprint(class UBoxComponent* box_, TArray<int32>& outTiles_);
+	void SetTileState(int32 index_, EGridTileState state_);
+	FTransform GetTileTransform(int32 index_);
+	void OnTileChanged(int32 index_);
 
 public:	
-	void UpdateCurrentTile(ATile* tile_, int rowSpeed_, int columnSpeed_, int depth_);
+	//For boards spawned at runtime, e.g. with another grid as the template. Only before BeginPlay.
+	//blockedTiles_ are blocked on top of the obstacles before the hierarchy is built
+	void SetupSpawned(int32 width_, int32 height_, bool bStreamTiles_, const TArray<int32>& blockedTiles_);
+
+	//Writes the grid with the obstacles and terrain areas placed in the level, and its hierarchy, to bakedGrid.
+	//Bake again after moving obstacles or terrain areas
+	UFUNCTION(CallInEditor, Category = "Grid|Baking")
+		void BakeGrid();
+
+	//Highlights every tile reachable from tileIndex_ for at most budget_ movement cost
+	void UpdateCurrentTile(int32 tileIndex_, int32 budget_);
+	//Same as UpdateCurrentTile with the range computed on a background thread. Tiles get highlighted once it's done
+	void UpdateCurrentTileAsync(int32 tileIndex_, int32 budget_);
+	//Highlights every tile reachable from tileIndex_ in at most steps_ steps, whatever the terrain.
+	//Cheap enough to run on the game thread. Paths to the highlighted tiles are searched inside them
+	void UpdateCurrentTileSteps(int32 tileIndex_, int32 steps_);
 	void ClearHighlighted();
 
-	void HighlightTiles(int rowSpeed_, int depth_);
+	void HighlightTiles();
+
+	FGridMap& GetGrid();
+	ATile* GetTileActor(int32 index_);
+	FVector GetTileLocation(int32 index_);
+	bool IsTileHighlighted(int32 index_);
+	const TArray<int32>& GetHighlightedTiles() const { return highlightedTiles; }
+	//Game thread time spent finishing async queries since the last call, in ms: highlighting a range or handing a path over to its caller
+	float ConsumeAsyncCompletionTime();
+	//Tile under a world location, straight down onto the board. INDEX_NONE if it's off the grid
+	int32 GetTileAtLocation(const FVector& location_);
+	//Where the ray crosses the board's plane, false if it points away from it
+	bool IntersectBoard(const FVector& origin_, const FVector& direction_, FVector& outLocation_);
+	//Tile picking without physics queries, so it doesn't matter whether tiles are actors or instances.
+	//Both return the grid the tile belongs to and nullptr if there's no tile there
+	static AGridManager* FindTileAtLocation(UWorld* world_, const FVector& location_, int32& tileIndex_);
+	//Closest tile along the ray, e.g. the mouse cursor's
+	static AGridManager* FindTileFromRay(UWorld* world_, const FVector& origin_, const FVector& direction_, int32& tileIndex_);
+	void HighlightPathTile(int32 index_);
+	//Path from start_ to goal_ through highlighted tiles, in walking order without start_
+	//Paths from the selected tile are read straight off the movement range
+	bool FindPath(int32 start_, int32 goal_, TArray<int32>& outPath_);
+	//Same as FindPath with the search on a background thread. onComplete_ runs on the game thread unless the returned query gets cancelled.
+	//Paths read off the current range complete right away and return no query
+	FGridAsyncQueryPtr FindPathAsync(int32 start_, int32 goal_, TFunction<void(bool, const TArray<int32>&)> onComplete_);
+	//Tiles of a path from start_ a unit has to walk through. Only the corners with bAnyAnglePaths, every tile otherwise
+	void GetWaypoints(int32 start_, const TArray<int32>& path_, TArray<int32>& outWaypoints_);
+	//Same as FindPath but anywhere on the grid, through the hierarchy when there is one
+	bool FindLongRangePath(int32 start_, int32 goal_, TArray<int32>& outPath_);
+	//Answers many long range queries at once, spread over the worker threads. Meant for AI turns
+	void FindPaths(const TArray<FGridPathRequest>& requests_, TArray<FGridPathResult>& outResults_);
+	//Field towards goal_ shared by every unit heading there. It's built on first use and kept until the grid changes
+	const FGridFlowField& GetFlowField(int32 goal_);
+	//Next tile to step on from tile_ to get to goal_, INDEX_NONE if there's none
+	int32 GetNextStep(int32 tile_, int32 goal_);
+	//Line of sight over the grid, obstacles block it. No physics queries, so it's fine to ask for every unit every turn
+	bool HasLineOfSight(int32 from_, int32 to_);
+	void HasLineOfSight(const TArray<FGridSightQuery>& queries_, TArray<bool>& outVisible_);
+	//Tiles visible from each origin within radius_ tiles, e.g. attack ranges. outResults_[i] belongs to origins_[i]
+	void GetVisibleTiles(const TArray<int32>& origins_, int32 radius_, TArray<FGridVisibility>& outResults_);
+	//Keeps the chunks around the actor loaded while streaming, e.g. for units acting off camera
+	void AddStreamingSource(AActor* source_);
+	void RemoveStreamingSource(AActor* source_);
+
+	//Keep everything built on top of the grid in sync with traversability and terrain changes
+	void SetTileTraversable(int32 index_, bool value_);
+	//In tenths of the default cost, see GridCost::DefaultTerrain
+	void SetTileTerrainCost(int32 index_, uint8 cost_);
+
+	//Blocks the tiles under the obstacle, moving its footprint if it was already known
+	void UpdateObstacle(class AObstacle* obstacle_);
+	void RemoveObstacle(class AObstacle* obstacle_);
+
+	//Starts a path query that stays alive and only redoes the work around tiles that change. Returns its handle
+	int32 TrackPath(int32 start_, int32 goal_);
+	//Current path of a tracked query from start_, which is where the unit is now
+	bool GetTrackedPath(int32 handle_, int32 start_, TArray<int32>& outPath_);
+	void StopTrackingPath(int32 handle_);
 };
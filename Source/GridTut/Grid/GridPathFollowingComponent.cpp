@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridPathFollowingComponent.h"
+#include "GameFramework/Pawn.h"
+
+UGridPathFollowingComponent::UGridPathFollowingComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	acceptanceRadius = 10.0f;
+	nextPoint = 0;
+	segmentStart = FVector::ZeroVector;
+}
+
+void UGridPathFollowingComponent::FollowPath(const TArray<FVector>& points_)
+{
+	APawn* pawn = Cast<APawn>(GetOwner());
+	points = points_;
+	nextPoint = 0;
+	if (!pawn || points.Num() == 0)
+	{
+		Stop();
+		return;
+	}
+	segmentStart = pawn->GetActorLocation();
+	SetComponentTickEnabled(true);
+}
+
+void UGridPathFollowingComponent::Stop()
+{
+	points.Reset();
+	nextPoint = 0;
+	SetComponentTickEnabled(false);
+}
+
+void UGridPathFollowingComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	APawn* pawn = Cast<APawn>(GetOwner());
+	if (!pawn || !IsFollowing())
+	{
+		Stop();
+		return;
+	}
+
+	//Skip every point that's been reached or walked past, so a fast pawn never turns back for one
+	const FVector2D location(pawn->GetActorLocation());
+	while (IsFollowing())
+	{
+		const FVector2D point(points[nextPoint]);
+		const FVector2D segment = point - FVector2D(segmentStart);
+		const bool bReached = FVector2D::DistSquared(location, point) <= FMath::Square(acceptanceRadius);
+		const bool bPassed = !segment.IsNearlyZero() && ((point - location) | segment) <= 0.0f;
+		if (!bReached && !bPassed)
+			break;
+		segmentStart = points[nextPoint];
+		nextPoint++;
+	}
+
+	if (!IsFollowing())
+	{
+		Stop();
+		return;
+	}
+
+	const FVector direction = points[nextPoint] - pawn->GetActorLocation();
+	pawn->AddMovementInput(FVector(direction.X, direction.Y, 0.0f).GetSafeNormal(), 1.0f);
+}
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "GridPathFollowingComponent.generated.h"
+
+//Walks the owning pawn along a precomputed grid path with movement input, one straight segment at a time.
+//No navmesh queries, so grid units don't need a navigation system. Only ticks while there's a path to follow
+UCLASS(ClassGroup = (Grid), meta = (BlueprintSpawnableComponent))
+class GRIDTUT_API UGridPathFollowingComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UGridPathFollowingComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	//Starts walking through points_ in order, replacing the path being followed. The pawn's own location isn't part of it
+	void FollowPath(const TArray<FVector>& points_);
+	void Stop();
+
+	bool IsFollowing() const { return nextPoint < points.Num(); }
+	//Where the pawn is headed right now, only valid while following
+	const FVector& GetNextPoint() const { return points[nextPoint]; }
+
+protected:
+	//How close to a point, seen from above, counts as being there
+	UPROPERTY(EditAnywhere, Category = "Grid")
+		float acceptanceRadius;
+
+private:
+	TArray<FVector> points;
+	int32 nextPoint;
+	//Start of the segment being walked, so passing a point without getting close still counts as reaching it
+	FVector segmentStart;
+};
@@ -2,6 +2,8 @@
 
 
 #include "Obstacle.h"
+#include "EngineUtils.h"
+#include "GridManager.h"
 
 // Sets default values
 AObstacle::AObstacle()
@@ -24,6 +26,41 @@ AObstacle::AObstacle()
 void AObstacle::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	box->TransformUpdated.AddUObject(this, &AObstacle::OnBoxMoved);
+	//Grids that already started won't look for obstacles again
+	NotifyGrids(false);
 }
 
+void AObstacle::EndPlay(const EEndPlayReason::Type endPlayReason_)
+{
+	box->TransformUpdated.RemoveAll(this);
+	NotifyGrids(true);
+
+	Super::EndPlay(endPlayReason_);
+}
+
+void AObstacle::OnBoxMoved(USceneComponent* component_, EUpdateTransformFlags flags_, ETeleportType teleport_)
+{
+	NotifyGrids(false);
+}
+
+void AObstacle::NotifyGrids(bool bRemoved_)
+{
+	for (TActorIterator<AGridManager> it(GetWorld()); it; ++it)
+	{
+		if (bRemoved_)
+		{
+			it->RemoveObstacle(this);
+		}
+		else
+		{
+			it->UpdateObstacle(this);
+		}
+	}
+}
+
+UBoxComponent* AObstacle::GetBox()
+{
+	return box;
+}
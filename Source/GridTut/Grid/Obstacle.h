@@ -20,6 +20,7 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type endPlayReason_) override;
 
 	UPROPERTY(EditAnywhere, Category = "Obstacle")
 		USceneComponent* root;
@@ -30,6 +31,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Obstacle")
 		UBoxComponent* box;
 
-public:	
+	//Keeps the grids' traversability in sync when the obstacle moves or goes away
+	void OnBoxMoved(USceneComponent* component_, EUpdateTransformFlags flags_, ETeleportType teleport_);
+	void NotifyGrids(bool bRemoved_);
 
+public:	
+	UBoxComponent* GetBox();
 };
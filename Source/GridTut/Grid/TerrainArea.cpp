@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TerrainArea.h"
+#include "GridMap.h"
+
+// Sets default values
+ATerrainArea::ATerrainArea()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent = root;
+
+	box = CreateDefaultSubobject<UBoxComponent>(TEXT("Box"));
+	box->SetupAttachment(root);
+	box->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	cost = GridCost::DefaultTerrain * 2;
+}
+
+UBoxComponent* ATerrainArea::GetBox()
+{
+	return box;
+}
+
+uint8 ATerrainArea::GetCost()
+{
+	return cost;
+}
@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Components/BoxComponent.h"
+#include "TerrainArea.generated.h"
+
+//Changes the movement cost of the tiles under its box, e.g. mud, roads or shallow water.
+//Areas are static, they're written into the grid when it's built or baked
+UCLASS()
+class GRIDTUT_API ATerrainArea : public AActor
+{
+	GENERATED_BODY()
+	
+public:	
+	// Sets default values for this actor's properties
+	ATerrainArea();
+
+protected:
+	UPROPERTY(EditAnywhere, Category = "Terrain")
+		USceneComponent* root;
+
+	UPROPERTY(EditAnywhere, Category = "Terrain")
+		UBoxComponent* box;
+
+	//In tenths of the default cost, 7 is a road and 20 is mud. Where areas overlap the cheaper one wins, so roads can cross rivers
+	UPROPERTY(EditAnywhere, Category = "Terrain", meta = (ClampMin = "1", ClampMax = "255"))
+		uint8 cost;
+
+public:	
+	UBoxComponent* GetBox();
+	uint8 GetCost();
+};
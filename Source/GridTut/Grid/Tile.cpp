@@ -4,7 +4,6 @@
 #include "Tile.h"
 #include "GridManager.h"
 #include "Engine/World.h"
-#include "Obstacle.h"
 
 // Sets default values
 ATile::ATile()
@@ -18,14 +17,7 @@ ATile::ATile()
 	mesh->SetupAttachment(root);
 
 	gridManager = nullptr;
-	bHighlighted = false;
-
-	//Each tile will have 8 neighbors at max
-	immediateNeighbors.Reserve(4);
-	diagonalNeighbors.Reserve(4);
-	gCost = hCost = fCost = 0;
-	bTraversable = true;
-	parentTile = nullptr;
+	tileIndex = INDEX_NONE;
 }
 
 // Called when the game starts or when spawned
@@ -33,20 +25,6 @@ void ATile::BeginPlay()
 {
 	Super::BeginPlay();
 
-	FHitResult hit;
-	FVector end = GetActorLocation();
-	FVector start = GetActorLocation();
-	end.Z += 400.0f;
-	//start.Z += 100.0F;
-	if (GetWorld()->LineTraceSingleByChannel(hit, start, end, ECollisionChannel::ECC_Visibility))
-	{
-		AObstacle* obstacle = Cast<AObstacle>(hit.Actor);
-		if (obstacle)
-		{
-			bTraversable = false;
-		}
-	}
-
 	//SetActorHiddenInGame(true);
 }
 
@@ -54,106 +32,59 @@ AGridManager* ATile::GetGridManager()
 {
 	return gridManager;
 }
-void ATile::SetGridManager(AGridManager* gridManager_)
+void ATile::SetGridManager(AGridManager* gridManager_, int32 tileIndex_)
 {
 	gridManager = gridManager_;
+	tileIndex = tileIndex_;
 }
 
-void ATile::Highlighted()
+int32 ATile::GetTileIndex()
 {
-	if (bTraversable)
-	{
-		SetActorHiddenInGame(false);
-		if (highlightedMaterial)
-			mesh->SetMaterial(2, highlightedMaterial);
+	return tileIndex;
+}
 
-		bHighlighted = true;
-	}
+void ATile::Highlighted()
+{
+	SetActorHiddenInGame(false);
+	if (highlightedMaterial)
+		mesh->SetMaterial(2, highlightedMaterial);
 }
 void ATile::NotHighlighted()
 {
 	//SetActorHiddenInGame(true);
 	if (originalMaterial)
 		mesh->SetMaterial(2, originalMaterial);
-
-	bHighlighted = false;
-	gCost = hCost = fCost = 0; //Reset fCost. The starting tile always has 0 fcost
 }
 
 bool ATile::GetHighlighted()
 {
-	return bHighlighted;
-}
-
-void ATile::AddImmediateNeighbor(ATile* tile_)
-{
-	if (tile_ != nullptr && tile_!=this && !immediateNeighbors.Contains(tile_))
-	{
-		immediateNeighbors.Push(tile_);
-		tile_->AddImmediateNeighbor(this);
-	}
-}
-
-void ATile::AddDiagonalNeighbor(ATile* tile_)
-{
-	if (tile_ != nullptr && tile_ != this && !diagonalNeighbors.Contains(tile_))
-	{
-		diagonalNeighbors.Push(tile_);
-		tile_->AddDiagonalNeighbor(this);
-	}
+	return gridManager && gridManager->IsTileHighlighted(tileIndex);
 }
 
-
-TArray<ATile*> ATile::GetImmediateNeighbors()
-{
-	return immediateNeighbors;
-}
-TArray<ATile*> ATile::GetDiagonalNeighbors()
+bool ATile::GetTraversable()
 {
-	return diagonalNeighbors;
+	return gridManager && gridManager->GetGrid().IsTraversable(tileIndex);
 }
 
-bool ATile::GetTraversable()
+void ATile::HighlightPath()
 {
-	return bTraversable;
+	if (pathMaterial)
+		mesh->SetMaterial(2, pathMaterial);
 }
 
-ATile* ATile::GetParentTile()
+UStaticMeshComponent* ATile::GetMesh()
 {
-	return parentTile;
+	return mesh;
 }
-void ATile::SetParentTile(ATile* tile_)
+UMaterialInterface* ATile::GetOriginalMaterial()
 {
-	parentTile = tile_;
+	return originalMaterial;
 }
-
-
-void ATile::CalculateHCost(ATile* tile_)
+UMaterialInterface* ATile::GetHighlightedMaterial()
 {
-	//hCost = FMath::Sqrt(FMath::Pow((GetActorLocation().X - tile_->GetActorLocation().X),2)
-			     //     + FMath::Pow((GetActorLocation().Y - tile_->GetActorLocation().Y), 2));
-
-	//Manhatten
-	hCost = FMath::Abs(GetActorLocation().X - tile_->GetActorLocation().X) 
-		  + FMath::Abs(GetActorLocation().Y - tile_->GetActorLocation().Y);
+	return highlightedMaterial;
 }
-
-void ATile::HighlightPath()
+UMaterialInterface* ATile::GetPathMaterial()
 {
-	if (pathMaterial)
-		mesh->SetMaterial(2, pathMaterial);
+	return pathMaterial;
 }
-
-void  ATile::HighlightNeighbor()
-{
-
-	for (int i = 0; i < immediateNeighbors.Num(); i++)
-	{
-		immediateNeighbors[i]->HighlightPath();
-	}
-
-	for (int i = 0; i < diagonalNeighbors.Num(); i++)
-	{
-		diagonalNeighbors[i]->HighlightPath();
-	}
-}
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "Components/StaticMeshComponent.h"
 #include "Tile.generated.h"
 
+//Visual view of one grid tile. All grid state lives in the grid manager's FGridMap
 UCLASS()
 class GRIDTUT_API ATile : public AActor
 {
@@ -38,36 +39,23 @@ protected:
 
 
 	class AGridManager* gridManager;
-	bool bHighlighted;
-
-	//Need different arrays for different neighbors to make cost calculations easier
-	TArray<ATile*> immediateNeighbors;
-	TArray<ATile*> diagonalNeighbors;
-	ATile* parentTile; //The tile from where we evaluated this tile's costs
-	bool bTraversable;
+	int32 tileIndex; //Index of the tile inside the grid map
 
 public:	
 	class AGridManager* GetGridManager();
-	void SetGridManager(class AGridManager* gridManager_);
+	void SetGridManager(class AGridManager* gridManager_, int32 tileIndex_);
+	int32 GetTileIndex();
 	void Highlighted();
 	void NotHighlighted();
 	bool GetHighlighted();
-	void AddImmediateNeighbor(ATile* tile_);
-	void AddDiagonalNeighbor(ATile* tile_);
 
 	bool GetTraversable();
 
-	TArray<ATile*> GetImmediateNeighbors();
-	TArray<ATile*> GetDiagonalNeighbors();
-	ATile* GetParentTile();
-	void SetParentTile(ATile*);
-
-	int gCost;
-	int hCost;
-	int fCost;
-
-	void CalculateHCost(ATile* tile_);
-
 	void HighlightPath();
-	void HighlightNeighbor();
+
+	//Used by the grid manager to draw the tile with instanced meshes
+	UStaticMeshComponent* GetMesh();
+	UMaterialInterface* GetOriginalMaterial();
+	UMaterialInterface* GetHighlightedMaterial();
+	UMaterialInterface* GetPathMaterial();
 };
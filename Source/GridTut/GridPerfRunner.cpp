@@ -0,0 +1,373 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridPerfRunner.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "RenderCore.h"
+#include "GridTut.h"
+#include "GridTutCharacter.h"
+#include "GridTutPlayerController.h"
+#include "Grid/GridManager.h"
+
+CSV_DEFINE_CATEGORY(GridPerf, true);
+
+namespace
+{
+	//Generated boards bigger than this get their tiles streamed
+	const int32 StreamedBoardSize = 128;
+	//How long to wait for the player controller and a unit on a grid
+	const float SetupTimeout = 10.0f;
+
+	float GetPercentile(TArray<float> values_, float percentile_)
+	{
+		if (values_.Num() == 0)
+			return 0.0f;
+		values_.Sort();
+		return values_[FMath::Clamp(FMath::CeilToInt(values_.Num() * percentile_) - 1, 0, values_.Num() - 1)];
+	}
+}
+
+AGridPerfRunner::AGridPerfRunner()
+{
+	//Ticks after everything else so the frame it records is complete
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+
+	moves = 20;
+	generatedSize = 0;
+	generatedDensity = 20;
+	frameBudget = 33.3f;
+	gameThreadBudget = 16.6f;
+	gridBudget = 2.0f;
+	moveTimeout = 10.0f;
+	bExitWhenDone = false;
+
+	step = EStep::Setup;
+	controller = nullptr;
+	character = nullptr;
+	grid = nullptr;
+	movesDone = 0;
+	failedMoves = 0;
+	stepTime = 0.0f;
+	bStartedMoving = false;
+	bCapturingCsv = false;
+	gridTime = 0.0f;
+	actionGridTime = 0.0f;
+	worstGridTime = 0.0f;
+}
+
+void AGridPerfRunner::SpawnFromCommandLine(UWorld* world_)
+{
+	const TCHAR* commandLine = FCommandLine::Get();
+	if (FParse::Param(commandLine, TEXT("gridperf")))
+	{
+		Spawn(world_, commandLine, true);
+	}
+}
+
+AGridPerfRunner* AGridPerfRunner::Spawn(UWorld* world_, const TCHAR* params_, bool bExitWhenDone_)
+{
+	if (!world_)
+		return nullptr;
+
+	FActorSpawnParameters params;
+	params.bDeferConstruction = true;
+	AGridPerfRunner* runner = world_->SpawnActor<AGridPerfRunner>(AGridPerfRunner::StaticClass(), FTransform::Identity, params);
+	if (!runner)
+		return nullptr;
+
+	FParse::Value(params_, TEXT("gridperfmoves="), runner->moves);
+	FParse::Value(params_, TEXT("gridperfsize="), runner->generatedSize);
+	FParse::Value(params_, TEXT("gridperfdensity="), runner->generatedDensity);
+	FParse::Value(params_, TEXT("gridperfframe="), runner->frameBudget);
+	FParse::Value(params_, TEXT("gridperfgame="), runner->gameThreadBudget);
+	FParse::Value(params_, TEXT("gridperfgrid="), runner->gridBudget);
+	runner->moves = FMath::Max(runner->moves, 1);
+	runner->generatedSize = FMath::Max(runner->generatedSize, 0);
+	runner->generatedDensity = FMath::Clamp(runner->generatedDensity, 0, 90);
+	runner->bExitWhenDone = bExitWhenDone_;
+	runner->FinishSpawning(FTransform::Identity);
+	return runner;
+}
+
+void AGridPerfRunner::BeginPlay()
+{
+	Super::BeginPlay();
+
+	//Same targets every run
+	random.Initialize(generatedSize * 1000 + generatedDensity);
+	step = EStep::Setup;
+	stepTime = 0.0f;
+}
+
+void AGridPerfRunner::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	stepTime += DeltaTime;
+	//Async ranges and paths finish on the game thread a few frames after the action that asked for them
+	if (grid)
+	{
+		const float asyncTime = grid->ConsumeAsyncCompletionTime();
+		gridTime += asyncTime;
+		actionGridTime += asyncTime;
+	}
+	if (step != EStep::Setup && step != EStep::Done)
+	{
+		const float frameTime = DeltaTime * 1000.0f;
+		const float gameThreadTime = FPlatformTime::ToMilliseconds(GGameThreadTime);
+		frameTimes.Add(frameTime);
+		gameThreadTimes.Add(gameThreadTime);
+		CSV_CUSTOM_STAT(GridPerf, FrameTime, frameTime, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(GridPerf, GameThreadTime, gameThreadTime, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(GridPerf, GridTime, gridTime, ECsvCustomStatOp::Set);
+	}
+	gridTime = 0.0f;
+
+	switch (step)
+	{
+	case EStep::Setup:
+		if (Setup())
+		{
+			step = EStep::Select;
+			stepTime = 0.0f;
+		}
+		else if (stepTime > SetupTimeout)
+		{
+			UE_LOG(LogGridTut, Error, TEXT("Grid perf: no player controller or no unit standing on a grid"));
+			Finish();
+		}
+		break;
+
+	case EStep::Select:
+		Select();
+		step = EStep::WaitForRange;
+		stepTime = 0.0f;
+		break;
+
+	case EStep::WaitForRange:
+		//The unit's own tile is always in its range, so one tile means nothing's been highlighted yet
+		if (grid->GetHighlightedTiles().Num() > 1)
+		{
+			Click();
+			step = EStep::Walk;
+			stepTime = 0.0f;
+			bStartedMoving = false;
+		}
+		else if (stepTime > moveTimeout)
+		{
+			UE_LOG(LogGridTut, Warning, TEXT("Grid perf: move %d, the range never showed up"), movesDone);
+			failedMoves++;
+			EndMove();
+		}
+		break;
+
+	case EStep::Walk:
+		bStartedMoving |= character->IsMoving();
+		if (bStartedMoving && !character->IsMoving())
+		{
+			EndMove();
+		}
+		else if (stepTime > moveTimeout)
+		{
+			UE_LOG(LogGridTut, Warning, TEXT("Grid perf: move %d didn't get there in %.1fs"), movesDone, moveTimeout);
+			failedMoves++;
+			EndMove();
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+bool AGridPerfRunner::Setup()
+{
+	controller = Cast<AGridTutPlayerController>(GetWorld()->GetFirstPlayerController());
+	if (!controller)
+		return false;
+
+	//The first unit standing on a grid
+	AGridManager* unitGrid = nullptr;
+	int32 tile = INDEX_NONE;
+	for (TActorIterator<AGridTutCharacter> it(GetWorld()); it && !unitGrid; ++it)
+	{
+		unitGrid = AGridManager::FindTileAtLocation(GetWorld(), it->GetActorLocation(), tile);
+		character = unitGrid ? *it : nullptr;
+	}
+	if (!unitGrid)
+		return false;
+
+	grid = unitGrid;
+	if (generatedSize > 0)
+	{
+		grid = SpawnGeneratedGrid(unitGrid);
+		if (!grid)
+			return false;
+
+		//Stands on the middle of the new board as high above it as it stood above its own
+		const float height = character->GetActorLocation().Z - unitGrid->GetActorLocation().Z;
+		const int32 center = grid->GetGrid().ToIndex(generatedSize / 2, generatedSize / 2);
+		character->SetActorLocation(grid->GetTileLocation(center) + FVector(0.0f, 0.0f, height), false, nullptr, ETeleportType::TeleportPhysics);
+	}
+
+#if CSV_PROFILER
+	if (!FCsvProfiler::Get()->IsCapturing())
+	{
+		FCsvProfiler::Get()->BeginCapture();
+		bCapturingCsv = true;
+	}
+#endif
+	UE_LOG(LogGridTut, Display, TEXT("Grid perf: %d moves of %s on %s, %dx%d"), moves, *character->GetName(), *grid->GetName(), grid->GetGrid().GetWidth(), grid->GetGrid().GetHeight());
+	return true;
+}
+
+AGridManager* AGridPerfRunner::SpawnGeneratedGrid(AGridManager* template_)
+{
+	//Same tiles and settings as the map's grid, right next to it
+	const FVector extent = template_->GetTileLocation(template_->GetGrid().Num() - 1) - template_->GetActorLocation();
+	const FTransform transform(template_->GetActorRotation(), template_->GetActorLocation() + FVector(0.0f, extent.Y + 1000.0f, 0.0f));
+
+	//The middle stays open so the unit has somewhere to stand
+	TArray<int32> blocked;
+	const int32 center = generatedSize / 2;
+	for (int32 y = 0; y < generatedSize; y++)
+	{
+		for (int32 x = 0; x < generatedSize; x++)
+		{
+			const bool bNearCenter = FMath::Abs(x - center) <= 2 && FMath::Abs(y - center) <= 2;
+			if (!bNearCenter && random.FRandRange(0.0f, 100.0f) < generatedDensity)
+			{
+				blocked.Add(y * generatedSize + x);
+			}
+		}
+	}
+
+	FActorSpawnParameters params;
+	params.Template = template_;
+	params.bDeferConstruction = true;
+	AGridManager* spawned = GetWorld()->SpawnActor<AGridManager>(template_->GetClass(), transform, params);
+	if (spawned)
+	{
+		spawned->SetupSpawned(generatedSize, generatedSize, generatedSize > StreamedBoardSize, blocked);
+		spawned->FinishSpawning(transform);
+	}
+	return spawned;
+}
+
+void AGridPerfRunner::Select()
+{
+	BeginGridAction();
+	const double start = FPlatformTime::Seconds();
+	controller->SelectCharacter(character);
+	EndGridTime(start);
+}
+
+void AGridPerfRunner::Click()
+{
+	//Anywhere in range but where the unit already is
+	const TArray<int32>& tiles = grid->GetHighlightedTiles();
+	const int32 currentTile = grid->GetTileAtLocation(character->GetActorLocation());
+	int32 target = tiles[random.RandHelper(tiles.Num())];
+	if (target == currentTile)
+	{
+		target = tiles[(tiles.Find(target) + 1) % tiles.Num()];
+	}
+
+	BeginGridAction();
+	const double start = FPlatformTime::Seconds();
+	controller->ClickTile(grid, target);
+	EndGridTime(start);
+}
+
+void AGridPerfRunner::EndMove()
+{
+	//Clicking off the board lets go of the unit, like the player would
+	BeginGridAction();
+	const double start = FPlatformTime::Seconds();
+	controller->ClickTile(nullptr, INDEX_NONE);
+	EndGridTime(start);
+
+	movesDone++;
+	stepTime = 0.0f;
+	step = movesDone < moves ? EStep::Select : EStep::Done;
+	if (step == EStep::Done)
+	{
+		Finish();
+	}
+}
+
+void AGridPerfRunner::BeginGridAction()
+{
+	worstGridTime = FMath::Max(worstGridTime, actionGridTime);
+	actionGridTime = 0.0f;
+}
+
+void AGridPerfRunner::EndGridTime(double startTime_)
+{
+	const float time = (float)((FPlatformTime::Seconds() - startTime_) * 1000.0);
+	gridTime += time;
+	actionGridTime += time;
+}
+
+void AGridPerfRunner::Finish()
+{
+	step = EStep::Done;
+#if CSV_PROFILER
+	if (bCapturingCsv)
+	{
+		FCsvProfiler::Get()->EndCapture();
+		bCapturingCsv = false;
+	}
+#endif
+
+	BeginGridAction();
+	const float frameTime = GetPercentile(frameTimes, 0.95f);
+	const float gameThreadTime = GetPercentile(gameThreadTimes, 0.95f);
+	if (frameTime > frameBudget)
+	{
+		failures.Add(FString::Printf(TEXT("Frame time p95 %.2f ms is over the %.2f ms budget"), frameTime, frameBudget));
+	}
+	if (gameThreadTime > gameThreadBudget)
+	{
+		failures.Add(FString::Printf(TEXT("Game thread time p95 %.2f ms is over the %.2f ms budget"), gameThreadTime, gameThreadBudget));
+	}
+	if (worstGridTime > gridBudget)
+	{
+		failures.Add(FString::Printf(TEXT("Worst grid time %.3f ms is over the %.3f ms budget"), worstGridTime, gridBudget));
+	}
+	if (movesDone != moves || failedMoves > 0)
+	{
+		failures.Add(FString::Printf(TEXT("%d of %d moves made it"), movesDone - failedMoves, moves));
+	}
+	const bool bPassed = failures.Num() == 0;
+
+	UE_LOG(LogGridTut, Display, TEXT("Grid perf: %d/%d moves, %d failed, %d frames"), movesDone, moves, failedMoves, frameTimes.Num());
+	UE_LOG(LogGridTut, Display, TEXT("Grid perf: frame p95 %.2f ms (budget %.2f), game thread p95 %.2f ms (budget %.2f), grid worst %.3f ms (budget %.3f)"),
+		frameTime, frameBudget, gameThreadTime, gameThreadBudget, worstGridTime, gridBudget);
+	for (const FString& failure : failures)
+	{
+		UE_LOG(LogGridTut, Error, TEXT("Grid perf: %s"), *failure);
+	}
+
+	const FString path = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"), TEXT("GridPerf.json"));
+	const FString json = FString::Printf(TEXT("{\n\t\"map\": \"%s\",\n\t\"grid\": \"%dx%d\",\n\t\"moves\": %d,\n\t\"failedMoves\": %d,\n\t\"frames\": %d,\n")
+		TEXT("\t\"frameTimeP95\": %.2f,\n\t\"gameThreadTimeP95\": %.2f,\n\t\"worstGridTime\": %.3f,\n")
+		TEXT("\t\"frameBudget\": %.2f,\n\t\"gameThreadBudget\": %.2f,\n\t\"gridBudget\": %.3f,\n\t\"passed\": %s\n}\n"),
+		*GetWorld()->GetMapName(), grid ? grid->GetGrid().GetWidth() : 0, grid ? grid->GetGrid().GetHeight() : 0, movesDone, failedMoves, frameTimes.Num(),
+		frameTime, gameThreadTime, worstGridTime, frameBudget, gameThreadBudget, gridBudget, bPassed ? TEXT("true") : TEXT("false"));
+	if (!FFileHelper::SaveStringToFile(json, *path))
+	{
+		UE_LOG(LogGridTut, Warning, TEXT("Grid perf: couldn't write %s"), *path);
+	}
+
+	if (bExitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "GridPerfRunner.generated.h"
+
+class AGridManager;
+class AGridTutCharacter;
+class AGridTutPlayerController;
+
+//End to end performance run of a real turn: select a unit, let its range highlight, click a tile in it and walk there, over and over.
+//It goes through the player controller and character like mouse clicks do, so it runs under -nullrhi without a cursor:
+//  UE4Editor GridTut.uproject TopDownExampleMap -game -nullrhi -unattended -gridperf [-gridperfsize=512] [-gridperfdensity=20]
+//      [-gridperfmoves=20] [-gridperfframe=33.3] [-gridperfgame=16.6] [-gridperfgrid=2.0]
+//-gridperfsize runs on a generated board of that size next to the map's grid instead of on the map's grid.
+//Frame, game thread and grid times are recorded in the CSV profiler and checked against the budgets in ms when the run ends.
+//A budget that's exceeded is logged as an error and marked in Saved/Benchmarks/GridPerf.json, then the game exits.
+//For a run that fails, e.g. on CI, use the GridTut.Perf automation test instead. It takes the same options:
+//  UE4Editor GridTut.uproject -game -nullrhi -unattended -ExecCmds="Automation RunTests GridTut.Perf; Quit"
+UCLASS()
+class GRIDTUT_API AGridPerfRunner : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGridPerfRunner();
+
+	//Spawns a runner set up from the command line if it has -gridperf
+	static void SpawnFromCommandLine(UWorld* world_);
+	//Spawns a runner set up from -gridperf* options in params_
+	static AGridPerfRunner* Spawn(UWorld* world_, const TCHAR* params_, bool bExitWhenDone_);
+
+	bool IsDone() const { return step == EStep::Done; }
+	//Budgets that were exceeded and anything else that went wrong, empty if the run passed
+	const TArray<FString>& GetFailures() const { return failures; }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void Tick(float DeltaTime) override;
+
+	//Moves to make before the run ends
+	UPROPERTY(EditAnywhere, Category = "Perf", meta = (ClampMin = "1"))
+		int32 moves;
+	//Side of the generated board, 0 runs on the grid the unit is placed on
+	UPROPERTY(EditAnywhere, Category = "Perf", meta = (ClampMin = "0"))
+		int32 generatedSize;
+	//Percent of the generated board's tiles that get blocked
+	UPROPERTY(EditAnywhere, Category = "Perf", meta = (ClampMin = "0", ClampMax = "90"))
+		int32 generatedDensity;
+	//95th percentile of the frame time, in ms
+	UPROPERTY(EditAnywhere, Category = "Perf|Budgets")
+		float frameBudget;
+	//95th percentile of the game thread time, in ms
+	UPROPERTY(EditAnywhere, Category = "Perf|Budgets")
+		float gameThreadBudget;
+	//Worst game thread time of a single select or click, in ms. Includes the grid queries, the highlighting
+	//and the async range or path that finishes on the game thread afterwards
+	UPROPERTY(EditAnywhere, Category = "Perf|Budgets")
+		float gridBudget;
+	//A move that takes longer than this fails the run, in seconds
+	UPROPERTY(EditAnywhere, Category = "Perf")
+		float moveTimeout;
+	//Quit the game once the run is done, for command line runs
+	UPROPERTY(EditAnywhere, Category = "Perf")
+		bool bExitWhenDone;
+
+private:
+	enum class EStep : uint8
+	{
+		Setup,
+		Select,
+		WaitForRange,
+		Walk,
+		Done
+	};
+
+	EStep step;
+	FRandomStream random;
+	AGridTutPlayerController* controller;
+	AGridTutCharacter* character;
+	AGridManager* grid;
+	int32 movesDone;
+	int32 failedMoves;
+	float stepTime;
+	bool bStartedMoving;
+	bool bCapturingCsv;
+
+	TArray<float> frameTimes;
+	TArray<float> gameThreadTimes;
+	float gridTime;
+	float actionGridTime;
+	float worstGridTime;
+	TArray<FString> failures;
+
+	bool Setup();
+	AGridManager* SpawnGeneratedGrid(AGridManager* template_);
+	void Select();
+	void Click();
+	//Lets go of the unit and starts the next move, or finishes the run
+	void EndMove();
+	void Finish();
+	//Grid time from here on belongs to a new select or click
+	void BeginGridAction();
+	//Keeps the time of the grid work a scripted action does on the game thread
+	void EndGridTime(double startTime_);
+};
@@ -54,18 +54,18 @@ AGridTutCharacter::AGridTutCharacter()
 	CursorToWorld->DecalSize = FVector(16.0f, 32.0f, 32.0f);
 	CursorToWorld->SetRelativeRotation(FRotator(90.0f, 0.0f, 0.0f).Quaternion());
 
+	PathFollower = CreateDefaultSubobject<UGridPathFollowingComponent>(TEXT("PathFollower"));
+
 	// Activate ticking in order to update the cursor every frame.
 	PrimaryActorTick.bCanEverTick = true;
 	PrimaryActorTick.bStartWithTickEnabled = true;
 
-	currentTile = nullptr;
-	targetTile = nullptr;
-
-	rowSpeed = 5;
-	columnSpeed = 3;
-	depth = 2;
+	gridManager = nullptr;
+	currentTile = INDEX_NONE;
+	targetTile = INDEX_NONE;
 
-	bMoving = false;
+	movementRange = 5;
+	bRangeInSteps = false;
 }
 
 void AGridTutCharacter::Tick(float DeltaSeconds)
@@ -84,204 +84,95 @@ void AGridTutCharacter::Tick(float DeltaSeconds)
 			CursorToWorld->SetWorldRotation(CursorR);
 		}
 	}
-
-	if (bMoving && path.Num()>0)
-	{
-		MoveAccordingToPath();
-	}
 }
 
 void AGridTutCharacter::Selected()
 {
-	FHitResult hit;
-	FVector end = GetActorLocation();
 	movementPath.Empty();
-	end.Z -= 400.0f;
-	if(GetWorld()->LineTraceSingleByChannel(hit, GetActorLocation(), end, ECollisionChannel::ECC_Visibility))
+	gridManager = AGridManager::FindTileAtLocation(GetWorld(), GetActorLocation(), currentTile);
+	if (gridManager && bRangeInSteps)
 	{
-		currentTile = Cast<ATile>(hit.Actor);
-		if (currentTile)
-		{			
-			currentTile->GetGridManager()->UpdateCurrentTile(currentTile, rowSpeed, columnSpeed, depth);
-		}
+		gridManager->UpdateCurrentTileSteps(currentTile, movementRange);
+	}
+	else if (gridManager)
+	{
+		gridManager->UpdateCurrentTileAsync(currentTile, movementRange * GridCost::Straight);
 	}
 }
 
 void AGridTutCharacter::NotSelected()
 {
-	if (currentTile)
+	CancelPathQuery();
+	if (gridManager)
 	{
-		currentTile->GetGridManager()->ClearHighlighted();
+		gridManager->ClearHighlighted();
 	}
 }
 
-void AGridTutCharacter::SetTargetTile(ATile* tile_)
+void AGridTutCharacter::SetTargetTile(int32 tile_)
 {
 	targetTile = tile_;
 }
 
-TArray<FVector> AGridTutCharacter::GetPath()
+void AGridTutCharacter::RequestPath(TFunction<void(const TArray<FVector>&)> onPath_)
 {
-	TArray<ATile*> open;
-	TArray<ATile*> closed;
-
-
-	ATile* currentNode = nullptr;
-
-	bool bFoundTarget = false;
-	open.Push(currentTile);
-
-	while (open.Num() > 0 )
+	CancelPathQuery();
+	PathFollower->Stop();
+	movementPath.Empty();
+	path.Empty();
+	if (!gridManager || currentTile == INDEX_NONE || targetTile == INDEX_NONE)
 	{
-		currentNode = GetTileWithMinFCost(open);
-
-		open.Remove(currentNode);
-
-		if (currentNode == targetTile) //We've found the goal, get out
-			break;
-
-		closed.Push(currentNode); //The current node has been visited
-
-		//Update parent nodes for immediate neighbors
-		for (int i = 0; i < currentNode->GetImmediateNeighbors().Num(); i++)
+		if (onPath_)
 		{
-			if (currentNode->GetImmediateNeighbors()[i] != nullptr)
-			{
-				if (closed.Contains(currentNode->GetImmediateNeighbors()[i])) //If the neighbor has already been visited, move on to the next one
-					continue;
-
-				currentNode->GetImmediateNeighbors()[i]->SetParentTile(currentNode); // Update the parent of the tile
-				if(currentNode->gCost + 10 < currentNode->GetImmediateNeighbors()[i]->gCost) //Update the gcost of the neighbor only if the new gcost is smaller than the previous one
-					currentNode->GetImmediateNeighbors()[i]->gCost = currentNode->gCost + 10; //Distance between node and imm neighbor is assumed 10
-				currentNode->GetImmediateNeighbors()[i]->CalculateHCost(targetTile);
-				currentNode->GetImmediateNeighbors()[i]->fCost = currentNode->GetImmediateNeighbors()[i]->gCost + currentNode->GetImmediateNeighbors()[i]->hCost;
-
-				if (!open.Contains(currentNode->GetImmediateNeighbors()[i]) 
-					&& !DoesClosedListHaveALowerFCost(open, currentNode->GetImmediateNeighbors()[i]->fCost)
-					&& !DoesOpenListHaveALowerFCost(open, currentNode->GetImmediateNeighbors()[i]->fCost)
-					&& currentNode->GetImmediateNeighbors()[i]->GetTraversable() 
-					&& currentNode->GetImmediateNeighbors()[i]->GetHighlighted())
-						open.Push(currentNode->GetImmediateNeighbors()[i]);
-			}
-			
-
+			onPath_(path);
 		}
+		return;
+	}
 
-		//Same as before but for diagonal neighbors
-		//Update parent for diagonal neighbors 
-		for (int d = 0; d < currentNode->GetDiagonalNeighbors().Num(); d++)
+	TWeakObjectPtr<AGridTutCharacter> weakThis(this);
+	pathQuery = gridManager->FindPathAsync(currentTile, targetTile, [weakThis, onPath_](bool bFound_, const TArray<int32>& tiles_)
+	{
+		if (AGridTutCharacter* character = weakThis.Get())
 		{
-			if (currentNode->GetDiagonalNeighbors()[d] != nullptr)
+			character->pathQuery.Reset();
+			const TArray<FVector>& points = character->SetMovementPath(bFound_, tiles_);
+			if (onPath_)
 			{
-				if (closed.Contains(currentNode->GetDiagonalNeighbors()[d]))
-					continue;
-
-				currentNode->GetDiagonalNeighbors()[d]->SetParentTile(currentNode);
-				if (currentNode->gCost + 14 < currentNode->GetDiagonalNeighbors()[d]->gCost)
-					currentNode->GetDiagonalNeighbors()[d]->gCost = currentNode->gCost + 14; //Distance between node and imm neighbor is assumed 10
-				currentNode->GetDiagonalNeighbors()[d]->CalculateHCost(targetTile);
-				currentNode->GetDiagonalNeighbors()[d]->fCost = currentNode->GetDiagonalNeighbors()[d]->gCost + currentNode->GetDiagonalNeighbors()[d]->hCost;
-
-				if (!open.Contains(currentNode->GetDiagonalNeighbors()[d])
-					&& !DoesClosedListHaveALowerFCost(open, currentNode->GetDiagonalNeighbors()[d]->fCost)
-					&& !DoesOpenListHaveALowerFCost(open, currentNode->GetDiagonalNeighbors()[d]->fCost)
-					&& currentNode->GetDiagonalNeighbors()[d]->GetTraversable() 
-					&& currentNode->GetDiagonalNeighbors()[d]->GetHighlighted())
-						open.Push(currentNode->GetDiagonalNeighbors()[d]);
+				onPath_(points);
 			}
-
 		}
-	}
-
-	UpdateMovementPath(targetTile);
-	currentTile->HighlightPath();
-
-	for (int i = 0; i < movementPath.Num(); i++)
-	{
-		movementPath[i]->HighlightPath();
-		path.Push(movementPath[i]->GetActorLocation());
-	}
-	bMoving = true;
-	return path;
+	});
 }
 
-void AGridTutCharacter::MoveAccordingToPath()
+void AGridTutCharacter::CancelPathQuery()
 {
-	FVector direction = path[path.Num()-1] - GetActorLocation();
-	if (FMath::Abs(path[path.Num() - 1].X - GetActorLocation().X) > 10.0f || FMath::Abs(path[path.Num() - 1].Y - GetActorLocation().Y) > 10.0f)
-	{
-		AddMovementInput(direction, 1.0f);
-	}
-	else
+	if (pathQuery.IsValid())
 	{
-		path.RemoveAt(path.Num() - 1);
-		if (path.Num() == 0)
-			bMoving = false;
+		pathQuery->Cancel();
+		pathQuery.Reset();
 	}
-
 }
 
-ATile* AGridTutCharacter::GetTileWithMinFCost(TArray<ATile*> tiles_)
+const TArray<FVector>& AGridTutCharacter::SetMovementPath(bool bFound_, const TArray<int32>& tiles_)
 {
-	int min = 0;
-	ATile* minTile = nullptr;
-	if (tiles_.Num() > 0)
-	{
-		min = tiles_[0]->fCost;
-		minTile = tiles_[0];
-		for (int i = 0; i < tiles_.Num(); i++)
-		{
-			if (tiles_[i]->fCost < min)
-			{
-				min = tiles_[i]->fCost;
-				minTile = tiles_[i];
-			}
-			else if (tiles_[i]->fCost == min && tiles_[i]->hCost < minTile->hCost)
-			{
-				min = tiles_[i]->fCost;
-				minTile = tiles_[i];
-			}
-		}
-	}
-
-	return minTile;
-}
+	movementPath.Empty();
+	path.Empty();
+	if (!bFound_ || !gridManager)
+		return path;
 
-void AGridTutCharacter::UpdateMovementPath(ATile* tile_)
-{
-	if (tile_->GetParentTile()!=nullptr && !movementPath.Contains(tile_))
+	movementPath = tiles_;
+	gridManager->HighlightPathTile(currentTile);
+	for (int i = 0; i < movementPath.Num(); i++)
 	{
-		movementPath.Push(tile_);
-		if( tile_->GetParentTile() != currentTile)
-			UpdateMovementPath(tile_->GetParentTile());
+		gridManager->HighlightPathTile(movementPath[i]);
 	}
-}
 
-bool AGridTutCharacter::DoesOpenListHaveALowerFCost(TArray<ATile*> list_, int fCost_)
-{
-	if (list_.Num() > 0)
+	TArray<int32> waypoints;
+	gridManager->GetWaypoints(currentTile, movementPath, waypoints);
+	for (int i = 0; i < waypoints.Num(); i++)
 	{
-		int min = fCost_;
-
-		for (int i = 0; i < list_.Num(); i++)
-		{
-			if (list_[i]->fCost < min)
-				return true;
-		}
+		path.Push(gridManager->GetTileLocation(waypoints[i]));
 	}
-	return false;
+	PathFollower->FollowPath(path);
+	return path;
 }
-bool AGridTutCharacter::DoesClosedListHaveALowerFCost(TArray<ATile*> list_, int fCost_)
-{
-	if (list_.Num() > 0)
-	{
-		int min = fCost_;
-
-		for (int i = 0; i < list_.Num(); i++)
-		{
-			if (list_[i]->fCost < min)
-				return true;
-		}
-	}
-	return false;
-}
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Grid/GridManager.h"
+#include "Grid/GridPathFollowingComponent.h"
 #include "GridTutCharacter.generated.h"
 
 UCLASS(Blueprintable)
@@ -24,6 +25,7 @@ public:
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns CursorToWorld subobject **/
 	FORCEINLINE class UDecalComponent* GetCursorToWorld() { return CursorToWorld; }
+	FORCEINLINE UGridPathFollowingComponent* GetPathFollower() const { return PathFollower; }
 
 private:
 	/** Top down camera */
@@ -38,36 +40,39 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	class UDecalComponent* CursorToWorld;
 
+	/** Walks the character along its grid paths */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Grid, meta = (AllowPrivateAccess = "true"))
+	UGridPathFollowingComponent* PathFollower;
+
 protected:
 
+	//How far the character can move in one go, in straight tiles. Diagonal steps cost a bit more
 	UPROPERTY(EditAnywhere, Category = "Grid")
-		int rowSpeed;
-	UPROPERTY(EditAnywhere, Category = "Grid")
-		int columnSpeed;
+		int32 movementRange;
+	//Count movementRange in steps, diagonals and rough terrain included, instead of in movement cost
 	UPROPERTY(EditAnywhere, Category = "Grid")
-		int depth;
+		bool bRangeInSteps;
 
-	ATile* currentTile;
-	ATile* targetTile;
-	TArray<ATile*> movementPath;
+	AGridManager* gridManager;
+	int32 currentTile;
+	int32 targetTile;
+	TArray<int32> movementPath;
+	FGridAsyncQueryPtr pathQuery;
 
-	ATile* GetTileWithMinFCost(TArray<ATile*> tiles_);
 	TArray<FVector> path;
 
-	bool bMoving;
-
-	void MoveAccordingToPath();
+	const TArray<FVector>& SetMovementPath(bool bFound_, const TArray<int32>& tiles_);
+	void CancelPathQuery();
 
 public:
 
 	void Selected();
 	void NotSelected();
-	void SetTargetTile(ATile* tile_);
-	TArray<FVector> GetPath();
-
-	void UpdateMovementPath(ATile* tile_);
-	bool DoesOpenListHaveALowerFCost(TArray<ATile*> list_, int fCost_);
-	bool DoesClosedListHaveALowerFCost(TArray<ATile*> list_, int fCost_);
+	void SetTargetTile(int32 tile_);
+	//Asks the grid for a path to the target tile and walks it once it's found. onPath_, if set, gets the locations walked through
+	//in walking order, or nothing if there's no path. A new request replaces the one before it if that one hasn't finished yet
+	void RequestPath(TFunction<void(const TArray<FVector>&)> onPath_);
+	bool IsMoving() const { return PathFollower->IsFollowing(); }
 
 	
 
@@ -3,6 +3,7 @@
 #include "GridTutGameMode.h"
 #include "GridTutPlayerController.h"
 #include "GridTutCharacter.h"
+#include "GridPerfRunner.h"
 #include "UObject/ConstructorHelpers.h"
 
 AGridTutGameMode::AGridTutGameMode()
@@ -16,4 +17,12 @@ AGridTutGameMode::AGridTutGameMode()
 	{
 		DefaultPawnClass = PlayerPawnBPClass.Class;
 	}
-}
\ No newline at end of file
+}
+
+void AGridTutGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	//Scripted performance run when the game is started with -gridperf
+	AGridPerfRunner::SpawnFromCommandLine(GetWorld());
+}
@@ -13,6 +13,8 @@ class AGridTutGameMode : public AGameModeBase
 
 public:
 	AGridTutGameMode();
+
+	virtual void StartPlay() override;
 };
 
 
@@ -1,7 +1,6 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "GridTutPlayerController.h"
-#include "Blueprint/AIBlueprintHelperLibrary.h"
 #include "Runtime/Engine/Classes/Components/DecalComponent.h"
 #include "HeadMountedDisplayFunctionLibrary.h"
 #include "GridTutCharacter.h"
@@ -14,31 +13,11 @@ AGridTutPlayerController::AGridTutPlayerController()
 	bShowMouseCursor = true;
 	DefaultMouseCursor = EMouseCursor::Crosshairs;
 	controlledCharacter = nullptr;
-	tileInPathIndex = 0;
+	targetGrid = nullptr;
+	targetTile = INDEX_NONE;
 	bMovingCamera = false;
 }
 
-void AGridTutPlayerController::PlayerTick(float DeltaTime)
-{
-	Super::PlayerTick(DeltaTime);
-
-	if (bMoveToMouseCursor)
-	{
-		if (path.Num() > 0) //Move until path has been traversed
-		{
-			if (SetNewMoveDestination(destination) <= 5.0f)
-			{
-				//Get the next tile location
-				UpdateDestination();
-			}
-		}
-		else
-		{
-			bMoveToMouseCursor = false;
-		}
-	}
-}
-
 void AGridTutPlayerController::SetupInputComponent()
 {
 	// set up gameplay key bindings
@@ -54,87 +33,73 @@ void AGridTutPlayerController::SetupInputComponent()
 }
 
 
-float AGridTutPlayerController::SetNewMoveDestination(const FVector DestLocation)
+void AGridTutPlayerController::HandleMousePress()
 {
-	APawn* const MyPawn = GetPawn();
-	if (MyPawn)
+	if (!controlledCharacter) //If we don't have a controller character, see if we've 
 	{
-		float const Distance = FVector::Dist(DestLocation, MyPawn->GetActorLocation());
-
-		UAIBlueprintHelperLibrary::SimpleMoveToLocation(this, DestLocation);
+		//Characters are still picked with a trace, only tiles skip physics
+		FHitResult hit;
+		GetHitResultUnderCursor(ECC_Camera, false, hit);
+		if (hit.bBlockingHit)
+		{
+			//UE_LOG(LogTemp, Warning, TEXT("Hit something"));
+			SelectCharacter(Cast<AGridTutCharacter>(hit.Actor));
+			//UE_LOG(LogTemp, Warning, TEXT("Got player"));
+		}
+	}
+	else
+	{
+		//The tile comes straight from where the cursor's ray crosses the board
+		FVector rayOrigin;
+		FVector rayDirection;
+		AGridManager* grid = nullptr;
+		int32 tile = INDEX_NONE;
+		if (DeprojectMousePositionToWorld(rayOrigin, rayDirection))
+		{
+			grid = AGridManager::FindTileFromRay(GetWorld(), rayOrigin, rayDirection, tile);
+		}
+		ClickTile(grid, tile);
+	}
+}
 
-		return Distance;
+void AGridTutPlayerController::SelectCharacter(AGridTutCharacter* character_)
+{
+	controlledCharacter = character_;
+	if (controlledCharacter)
+	{
+		controlledCharacter->Selected();
+		SetViewTargetWithBlend(controlledCharacter,0.35f);		
+		if(srpgPawn)
+			srpgPawn->SetUnderControl(false);
 	}
-	return 0.0f;
 }
 
-void AGridTutPlayerController::HandleMousePress()
+void AGridTutPlayerController::ClickTile(AGridManager* grid_, int32 tile_)
 {
-	FHitResult hit;
-	GetHitResultUnderCursor(ECC_Camera, false, hit);
+	if (!controlledCharacter)
+		return;
 
-	if (hit.bBlockingHit)
+	targetGrid = grid_;
+	targetTile = tile_;
+	if (targetGrid)
 	{
-		//UE_LOG(LogTemp, Warning, TEXT("Hit something"));
-		if (!controlledCharacter) //If we don't have a controller character, see if we've 
+		if (targetGrid->IsTileHighlighted(targetTile))
 		{
-			controlledCharacter = Cast<AGridTutCharacter>(hit.Actor);
-			if (controlledCharacter)
-			{
-				controlledCharacter->Selected();
-				SetViewTargetWithBlend(controlledCharacter,0.35f);		
-				if(srpgPawn)
-					srpgPawn->SetUnderControl(false);
-			}
-			//UE_LOG(LogTemp, Warning, TEXT("Got player"));
-
-		
+			//The search runs in the background, clicking another tile before it's done replaces it.
+			//The character walks the path itself once it's found
+			controlledCharacter->SetTargetTile(targetTile);
+			controlledCharacter->RequestPath(nullptr);
 		}
 		else
 		{
-			 targetTile = Cast<ATile>(hit.Actor);
-			if (targetTile)
-			{
-				//UE_LOG(LogTemp, Warning, TEXT("Got Tile"));
-				// We hit a tile, move there
-					// set flag to keep updating destination until released
-				if (targetTile->GetHighlighted())
-				{
-					controlledCharacter->SetTargetTile(targetTile);
-					path = controlledCharacter->GetPath();
-					if (path.Num() > 0)
-					{
-						//bMoveToMouseCursor = true;
-						tileInPathIndex = 0;
-						destination = path[0];
-					}
-				}
-				else
-				{
-					controlledCharacter->NotSelected();
-					controlledCharacter = nullptr;
-				}
-			}
-			else
-			{
-				controlledCharacter->NotSelected();
-				controlledCharacter = nullptr;
-			}
+			controlledCharacter->NotSelected();
+			controlledCharacter = nullptr;
 		}
 	}
-}
-
-void AGridTutPlayerController::UpdateDestination()
-{
-	//We have arrived at destination so remove it and move on to the next one
-	if (tileInPathIndex < path.Num())
+	else
 	{
-		path.RemoveAt(tileInPathIndex);
-		tileInPathIndex++;
-		if (tileInPathIndex < path.Num())
-		{
-			destination = path[tileInPathIndex];
-		}
+		controlledCharacter->NotSelected();
+		controlledCharacter = nullptr;
 	}
 }
 
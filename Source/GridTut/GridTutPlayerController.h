@@ -5,7 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
 #include "GridTutCharacter.h"
-#include "Grid/Tile.h"
+#include "Grid/GridManager.h"
 #include "SRPGPlayer.h"
 #include "GridTutPlayerController.generated.h"
 
@@ -19,29 +19,25 @@ public:
 
 	void SetSRPGPawn(ASRPGPlayer* pawn_);
 
-protected:
-	/** True if the controlled character should navigate to the mouse cursor. */
-	uint32 bMoveToMouseCursor : 1;
+	//What a click does, without the cursor. Also used to script the game, e.g. by AGridPerfRunner
+	//Takes control of the character and shows its movement range
+	void SelectCharacter(AGridTutCharacter* character_);
+	//Moves the controlled character to the tile if it's in range, lets go of it otherwise. A null grid_ is a click off the board
+	void ClickTile(AGridManager* grid_, int32 tile_);
+	AGridTutCharacter* GetControlledCharacter() const { return controlledCharacter; }
 
+protected:
 	// Begin PlayerController interface
-	virtual void PlayerTick(float DeltaTime) override;
 	virtual void SetupInputComponent() override;
 	// End PlayerController interface
-	
-	/** Navigate player to the given world location. */
-	float SetNewMoveDestination(const FVector DestLocation);
 
 	/** Input handlers for SetDestination action. */
 	void HandleMousePress();
 
 	AGridTutCharacter* controlledCharacter;
 	ASRPGPlayer* srpgPawn;
-	ATile* targetTile;
-	FVector destination;
-	TArray<FVector> path;
-	int tileInPathIndex;
-
-	void UpdateDestination();
+	AGridManager* targetGrid;
+	int32 targetTile;
 
 	bool bMovingCamera;
 
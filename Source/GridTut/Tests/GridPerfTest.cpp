@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GridPerfRunner.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	const TCHAR* PerfMap = TEXT("/Game/TopDownCPP/Maps/TopDownExampleMap");
+
+	UWorld* GetGameWorld()
+	{
+		for (const FWorldContext& context : GEngine->GetWorldContexts())
+		{
+			if ((context.WorldType == EWorldType::Game || context.WorldType == EWorldType::PIE) && context.World())
+				return context.World();
+		}
+		return nullptr;
+	}
+
+	//Runs a perf runner in the loaded map until it's done and turns everything it reports as failed into test errors.
+	//The runner has its own timeouts, so it always gets done
+	class FGridPerfRunCommand : public IAutomationLatentCommand
+	{
+	public:
+		FGridPerfRunCommand(FAutomationTestBase* test_, const FString& params_)
+			: test(test_), params(params_), bSpawned(false)
+		{
+		}
+
+		virtual bool Update() override
+		{
+			if (!bSpawned)
+			{
+				bSpawned = true;
+				runner = AGridPerfRunner::Spawn(GetGameWorld(), *params, false);
+				if (!runner.IsValid())
+				{
+					test->AddError(TEXT("Couldn't spawn a grid perf runner, is the map loaded?"));
+					return true;
+				}
+				return false;
+			}
+
+			if (!runner.IsValid())
+			{
+				test->AddError(TEXT("The grid perf runner went away before it was done"));
+				return true;
+			}
+			if (!runner->IsDone())
+				return false;
+
+			for (const FString& failure : runner->GetFailures())
+			{
+				test->AddError(failure);
+			}
+			runner->Destroy();
+			return true;
+		}
+
+	private:
+		FAutomationTestBase* test;
+		FString params;
+		TWeakObjectPtr<AGridPerfRunner> runner;
+		bool bSpawned;
+	};
+}
+
+//Same run as -gridperf, failing the test when a budget is exceeded. Needs a game world:
+//  UE4Editor GridTut.uproject -game -nullrhi -unattended -ExecCmds="Automation RunTests GridTut.Perf; Quit"
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FGridPerfTest, "GridTut.Perf", EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+void FGridPerfTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	//The parameters are the runner's -gridperf* options
+	OutBeautifiedNames.Add(TEXT("MapGrid"));
+	OutTestCommands.Add(TEXT(""));
+	OutBeautifiedNames.Add(TEXT("Generated512"));
+	OutTestCommands.Add(TEXT("-gridperfsize=512"));
+}
+
+bool FGridPerfTest::RunTest(const FString& Parameters)
+{
+	ADD_LATENT_AUTOMATION_COMMAND(FLoadGameMapCommand(PerfMap));
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitForMapToLoadCommand());
+	ADD_LATENT_AUTOMATION_COMMAND(FGridPerfRunCommand(this, Parameters));
+	return true;
+}
+
+#endif